@@ -1,77 +1,101 @@
-#ifndef BOARD_H
-#define BOARD_H
-
-#include <string>
-#include <vector>
-#include <unordered_set>
-#include "bot.h"
-
-enum State;
-enum MoveResult;
-struct Action;
-struct SetHashStruct;
-struct PairHashStruct;
-
-class Board {
-public:
-	//Constructors and destructor
-	Board(int rows, int columns, int num_mines);
-	Board(int rows, int columns, int num_mines, std::string seed);
-	~Board();
-
-	//Print board to terminal
-	void print_board();
-	void print_count();
-
-	//Board behavior
-	bool handle_action(Action* act);
-	MoveResult make_move(int i, int j);
-	void mark_mine(int i, int j);
-
-	//Square queries (safe for bot/player)
-	bool is_known(int i, int j);
-	bool is_safe(int i, int j);
-	bool is_marked_mine(int i, int j);
-	bool square_has_state(int i, int j, State* states, int num_states);
-	int get_count(int i, int j);
-
-	//Board accessor methods
-	int get_rows();
-	int get_cols();
-	int get_mines();
-	Bot* get_bot();
-
-private:
-	//Various initialization and cleanup methods
-	void free_and_reset();
-	void reset_board();
-	void reset_board(std::string seed);
-	void board_from_seed(std::string seed);
-	std::string compress_seed(std::string seed);
-	std::string decompress_seed(std::string seed);
-
-	//Various methods
-	void update_mines_as_cross();
-	void print_stats();
-	int simulate(int num_iterations);
-
-	//Board setup values
-	int m_rows;
-	int m_cols;
-	int m_mines;
-	std::string m_seed;
-
-	//Board state
-	State** m_board;
-	int** m_counts;
-	char** m_board_display;
-
-	//Board state
-	int mines_marked;
-	int squares_revealed;
-	int move_count;
-	bool active;
-	Bot m_bot;
-};
-
+#ifndef BOARD_H
+#define BOARD_H
+
+#include <string>
+#include <vector>
+#include <unordered_set>
+#include "bot.h"
+#include "board_view.h"
+#include "game_record.h"
+
+#define AUTOTUNE_MIN_SIZE 8 //Smallest edge search limit simulated by autotune
+#define AUTOTUNE_MAX_SIZE 18 //Largest edge search limit simulated by autotune
+#define AUTOTUNE_STEP 2
+
+enum State;
+enum MoveResult;
+struct Action;
+struct SetHashStruct;
+struct PairHashStruct;
+
+class Board : public BoardView {
+public:
+	//Constructors and destructor
+	Board(int rows, int columns, int num_mines);
+	Board(int rows, int columns, int num_mines, std::string seed);
+	Board(int rows, int columns, int num_mines, std::string seed, bool verbose_output);
+	~Board();
+
+	//Print board to terminal
+	void print_board();
+	void print_count();
+
+	//Board behavior
+	bool handle_action(Action* act);
+	MoveResult make_move(int i, int j);
+	void mark_mine(int i, int j);
+	void load_seed(std::string seed);
+	void set_verbose(bool verbose_output);
+	void set_record_writer(RecordWriter* writer);
+
+	//Square queries (safe for bot/player)
+	bool is_known(int i, int j);
+	bool is_safe(int i, int j);
+	bool is_marked_mine(int i, int j);
+	bool square_has_state(int i, int j, State* states, int num_states);
+	int get_count(int i, int j);
+
+	//Board accessor methods
+	int get_rows();
+	int get_cols();
+	int get_mines();
+	std::string get_seed();
+	int get_mines_marked();
+	int get_squares_revealed();
+	bool is_active();
+	Bot* get_bot();
+
+	//Seed conversion
+	static std::string compress_seed(std::string seed);
+	static std::string decompress_seed(std::string seed);
+	static void decompress_seed(const char* seed, int length, std::string* output);
+
+private:
+	//Various initialization and cleanup methods
+	void free_and_reset();
+	void free_board();
+	void reset_board();
+	void reset_board(std::string seed);
+	void board_from_seed(std::string seed);
+
+	//Various methods
+	void update_mines_as_cross();
+	void print_stats();
+	int simulate(int num_iterations);
+	void autotune(int num_iterations);
+
+	//Board setup values
+	int m_rows;
+	int m_cols;
+	int m_mines;
+	std::string m_seed;
+
+	//Board state
+	State** m_board;
+	int** m_counts;
+	char** m_board_display;
+
+	//Board state
+	int mines_marked;
+	int squares_revealed;
+	int move_count;
+	bool active;
+	bool verbose;
+	Bot m_bot;
+
+	//Records of simulated games (nullptr to not record them)
+	RecordWriter* records;
+	RecordBlock record_block;
+};
+
 #endif //BOARD_H
\ No newline at end of file
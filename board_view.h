@@ -0,0 +1,30 @@
+#ifndef BOARD_VIEW_H
+#define BOARD_VIEW_H
+
+#include "util.h"
+
+//Interface through which the bot sees a board: the state and count of each square and the number of mines
+//The bot only reveals squares and marks mines through make_move and mark_mine
+class BoardView {
+public:
+	virtual ~BoardView() {}
+
+	//Board accessor methods
+	virtual int get_rows() = 0;
+	virtual int get_cols() = 0;
+	virtual int get_mines() = 0;
+	virtual int get_mines_marked() = 0;
+	virtual int get_squares_revealed() = 0;
+
+	//Square queries
+	virtual bool is_known(int i, int j) = 0;
+	virtual bool is_safe(int i, int j) = 0;
+	virtual bool is_marked_mine(int i, int j) = 0;
+	virtual int get_count(int i, int j) = 0;
+
+	//Board behavior
+	virtual MoveResult make_move(int i, int j) = 0;
+	virtual void mark_mine(int i, int j) = 0;
+};
+
+#endif //BOARD_VIEW_H
@@ -1,635 +1,2450 @@
-#include "bot.h"
-#include "board.h"
-#include "util.h"
-#include <iostream>
-#include <unordered_map>
-#include <unordered_set>
-#include <algorithm>
-#include <vector>
-#include <math.h>
-
-using namespace std;
-
-//Reset bot to initial state
-void Bot::reset() {
-	if (m_probabilities != nullptr) {
-		free();
-	}
-	last_result = CONTINUE;
-	move_queue.clear();
-}
-
-//Constructor for default values
-Bot::Bot(){
-	m_probabilities = nullptr;
-	MAX_SIZE = 10;
-}
-
-//Destructor
-Bot::~Bot() {
-	free();
-}
-
-//Set board pointer, copy frequently accessed values to this object
-void Bot::set_board(Board* b) {
-	board = b;
-	m_rows = b->get_rows();
-	m_cols = b->get_cols();
-	m_mines = b->get_mines();
-
-	m_probabilities = new double* [m_rows];
-	for (int i = 0; i < m_rows; i++) {
-		m_probabilities[i] = new double[m_cols];
-	}
-}
-
-//Set maximum edge length
-void Bot::set_edge_search_limit(int size) {
-	MAX_SIZE = size;
-}
-
-//Enable/disable approximation
-void Bot::set_edge_subset_approximation(bool approximate) {
-	edge_subset_approximation = approximate;
-}
-
-//Main method: search for the next optimal move
-MoveResult Bot::select_next_move() {
-	if (check_queue_empty()) return last_result; //See if existing safe move exists
-	cout << "No existing move in queue, beginning single square search" << endl;
-	single_square_search(); //Search for safe move/mark flags with single square information
-	if (check_queue_empty()) return last_result;
-	cout << "No single square found, beginning edge search" << endl;
-	edge_search(); //Use edge-based search 
-	if (check_queue_empty()) return last_result;
-	cout << "Guessing" << endl;
-	return guess_random_square(); //Guess based on probabilities/corner-edge heuristic
-}
-
-//Free all memory for probability array
-void Bot::free() {
-	for (int i = 0; i < m_rows; i++) {
-		delete[] m_probabilities[i];
-	}
-	delete[] m_probabilities;
-}
-
-//Check if there are any safe moves queued, making the move if it exists
-//This allows us to search in batches, using the safe moves from each batch over several moves
-bool Bot::check_queue_empty() {
-	while (!move_queue.empty()) {
-		pair<int, int> p = move_queue.at(0);
-		move_queue.erase(move_queue.begin());
-		if (!board->is_known(p.first, p.second)) {
-			cout << "Safe move found" << endl;
-			last_result = board->make_move(p.first, p.second);
-			return true;
-		}
-	}
-	return false;
-}
-
-//Search for safe squares and mines using only those square's constraints
-//Extremely effective when large edges are revealed at decreasing the frequency of expensive edge searches
-void Bot::single_square_search() {
-	for (int i = 0; i < m_rows; i++) { //Iterate over each square
-		for (int j = 0; j < m_cols; j++) {
-			if (board->is_safe(i, j)) {
-				int known_mines = 0;
-				int open_spaces = 0;
-				execute_callback(board, i, j, &count_known_mines, &known_mines); //Count number of known mines adjacent to square
-				execute_callback(board, i, j, &count_unknown_spaces, &open_spaces); //Count number of open spaces adjacent to square
-
-				if (board->get_count(i, j) == open_spaces + known_mines) { //Each open square is a mine, mark them
-					execute_callback(board, i, j, &mark_as_known_mine, nullptr);
-				}
-				if (board->get_count(i, j) == known_mines) { //No possible mines, square is safe so add to queue
-					execute_callback(board, i, j, &append_to_vector, &move_queue);
-				}
-			}
-		}
-	}
-}
-
-//Guesses best probability move available
-//Probabilities are not updated each move, but will occur before any guess (due to edge search)
-//Uses heuristic of being closest to the edges/corners to try to avoid 50/50 guesses near end of game
-MoveResult Bot::guess_random_square() {
-	int top = 0, bottom = m_rows - 1, left = 0, right = m_cols - 1;
-	int dir = 0;
-	double min_probability = -1.0;
-	pair<int, int> best_guess;
-
-	//Spiral traversal
-	while (top <= bottom && left <= right) {
-		if (dir == 0) {
-			for (int i = left; i <= right; i++) { //left to right
-				if (!board->is_known(top, i) && (min_probability < 0 || m_probabilities[top][i] < min_probability)) {
-					best_guess = make_pair(top, i);
-					min_probability = m_probabilities[top][i];
-				}
-			}
-			top++;
-		}
-		else if (dir == 1) {
-			for (int i = top; i <= bottom; i++) { //Top to bottom
-				if (!board->is_known(i, right) && (min_probability < 0 || m_probabilities[i][right] < min_probability)) {
-					best_guess = make_pair(i, right);
-					min_probability = m_probabilities[i][right];
-				}
-			}
-			right -= 1;
-		}
-		else if (dir == 2) {
-			for (int i = right; i >= left; i--) { //Right to left 
-				if (!board->is_known(bottom, i) && (min_probability < 0 || m_probabilities[bottom][i] < min_probability)) {
-					best_guess = make_pair(bottom, i);
-					min_probability = m_probabilities[bottom][i];
-				}
-			}
-			bottom -= 1;
-		}
-		else {
-			for (int i = bottom; i >= top; i--) { //Left to top
-				if (!board->is_known(i, left) && (min_probability < 0 || m_probabilities[i][left] < min_probability)) {
-					best_guess = make_pair(i, left);
-					min_probability = m_probabilities[i][left];
-				}
-			}
-			left += 1;
-		}
-
-		dir = (dir + 1) % 4;
-	}
-	cout << "Best probability move: " << (1 - min_probability) * 100 << "%" << endl;
-	return board->make_move(best_guess.first, best_guess.second);
-}
-
-//Indepth search of each edge for all possibilities with given constraints
-//Will select best probability move and find any safe squares/guaranteed mines
-//May approximate for long edges
-void Bot::edge_search() {
-	vector<vector<pair<int, int>>*>* edges = get_edges();
-
-	double count_tot = 0;
-	double count_known = 0;
-	double count_edge = 0;
-	for (int i = 0; i < m_rows; i++) { //Count number of unknown squares and number of marked mines
-		for (int j = 0; j < m_cols; j++) {
-			if (board->is_marked_mine(i, j)) {
-				count_known += 1;
-			}
-			else if (!board->is_known(i, j)) {
-				count_tot += 1;
-			}
-		}
-	}
-	for (int i = 0; i < edges->size(); i++) { //Count total number of squares in edges
-		count_edge += (*edges)[i]->size();
-	}
-
-	double edge_mines = 0;
-	for (int i = 0; i < edges->size(); i++) { //Update probabilities of each edge
-		edge_mines += update_probabilities((*edges)[i]);
-	}
-
-	unordered_set<pair<int, int>, PairHashStruct> in_edges;
-	for (vector<pair<int, int>>* v : *edges) { //Copy edges to set for faster search
-		for (pair<int, int> p : *v) {
-			in_edges.insert(p);
-		}
-	}
-
-	for (int i = 0; i < m_rows; i++) { //Set all probabilities to probability of non-edge mine
-		for (int j = 0; j < m_cols; j++) {
-			if (in_edges.find(make_pair(i, j)) == in_edges.end()) {
-				if (m_mines - count_known - edge_mines == count_tot - count_edge) { //More primitive approximation
-					m_probabilities[i][j] = (m_mines - count_known) / (count_tot);
-				}
-				else { //Better approximation
-					m_probabilities[i][j] = (m_mines - count_known - edge_mines) / (count_tot - count_edge);
-				}
-			}
-		}
-	}
-
-	for (int i = 0; i < m_rows; i++) { //Mark all known mines, add all safe edges
-		for (int j = 0; j < m_cols; j++) {
-			if (m_probabilities[i][j] == 0.0) {
-				move_queue.push_back(make_pair(i, j));
-			}
-			if (m_probabilities[i][j] == 1.0 && !board->is_known(i, j)) {
-				board->mark_mine(i, j);
-			}
-		}
-	}
-
-	while (!edges->empty()) { //Cleanup
-		delete edges->back();
-		edges->pop_back();
-	}
-	delete edges;
-}
-
-//Returns vector of vector of pairs, each vector of pairs representing an edge
-//In this context, an edge is any set of unknown squares sharing a common set of constraints
-vector<vector<pair<int, int>>*>* Bot::get_edges() { //Returns vector of edges (each edge is a vector of pairs representing a square along that edge)
-	unordered_set<pair<int, int>, PairHashStruct> visited;
-	vector<vector<pair<int, int>>*>* vec = new vector<vector<pair<int, int>>*>;
-	vector<pair<int, int>> search_queue;
-
-	for (int i = 0; i < m_rows; i++) {
-		for (int j = 0; j < m_cols; j++) { //Iterate over each square
-			pair<int, int> p = make_pair(i, j);
-			if (visited.find(p) == visited.end() && !board->is_known(i, j)) { //Only consider non-visited and unknown squares
-				search_queue.clear();
-				search_queue.push_back(p);
-				vector<pair<int, int>>* edge = new vector<pair<int, int>>;
-				while (!search_queue.empty()) { //Loop through search queue
-					pair<int, int> t = search_queue.at(0); //Pop first square in queue
-					search_queue.erase(search_queue.begin());
-					if (visited.find(make_pair(t.first, t.second)) == visited.end()) { //Check that square hasn't been put in current edge already
-						vector<pair<int, int>> v;
-						execute_callback(board, t.first, t.second, &append_known_to_vector, &v);
-						if (v.size() != 0) {
-							for (vector<pair<int, int>>::iterator itr = v.begin(); itr != v.end(); itr++) { //Copy adjacent squares into search queue
-								if (visited.find(make_pair(itr->first, itr->second)) == visited.end()) {
-									execute_callback(board, itr->first, itr->second, &append_to_vector, &search_queue);
-								}
-								visited.insert(make_pair(itr->first, itr->second));
-							}
-							edge->push_back(t);
-						}
-						visited.insert(t); //Mark each visited square
-					}
-				}
-				if (!edge->empty()) { //Add edge to list of edges
-					vec->push_back(edge);
-				}
-				else {
-					delete edge;
-				}
-				visited.insert(p); //Mark as visited
-			}
-		}
-	}
-
-	return vec;
-}
-
-//Redirect call to update probabilities to appropriate method
-double Bot::update_probabilities(vector<pair<int, int>>* edge) {
-	cout << "Updating probability for edge: ";
-	for (pair<int, int> p : *edge) {
-		cout << "(" << p.first << ", " << p.second << ")";
-	}
-	cout << endl;
-
-	if (edge_subset_approximation && edge->size() >= MAX_SIZE) {
-		cout << "Edge too large, using subset edge search" << endl;
-		return update_probabilities_sectioned(edge);
-	}
-	else {
-		return update_probabilities_precise(edge);
-	}
-
-}
-
-//Brute force algorithm for calculating edge probabilities
-//Guaranteed optimal results, but runs in exponential time and struggles with large enough edges
-double Bot::update_probabilities_precise(vector<pair<int, int>>* edge) { //Precisely calculates probabilities for small edges
-	int* good_count = new int[NUM_THREADS * edge->size()];
-	int success_count[NUM_THREADS] = { 0 };
-	int flag_count = 0;
-	double mine_count = 0;
-
-	unordered_map<pair<int, int>, int, PairHashStruct> adjacent_counts; //For each edge square, store number of adjacent squares (known squares) bordering the edge 
-	for (int i = 0; i < edge->size(); i++) {
-		pair<int, int> p = (*edge)[i];
-		execute_callback(board, p.first, p.second, &insert_into_map, &adjacent_counts);
-	}
-
-	for (pair<pair<int, int>, int> p : adjacent_counts) { //For each adjacent square, count the number of mines in the edge
-		flag_count = 0;
-		execute_callback(board, p.first.first, p.first.second, &count_known_mines, &flag_count);
-		adjacent_counts[p.first] -= flag_count;
-	}
-
-	int count_possibilities = 0;
-
-	for (int i = 0; i < edge->size(); i++) { //Reset probabilities of edge squares
-		pair<int, int> p = (*edge)[i];
-		m_probabilities[p.first][p.second] = 0;
-	}
-
-	for (int i = 0; i < (int)pow(2, edge->size()); i++) { //Check each possibility (exponential time)
-		unordered_map<pair<int, int>, int, PairHashStruct> possibility_counts;
-		for (pair<pair<int, int>, int> p : adjacent_counts) { //Deep copy of adjacent_count
-			possibility_counts[p.first] = p.second;
-		}
-
-		for (int j = 0; j < edge->size(); j++) { //Subtract counts if the current possibility has edge square as flag
-			if (((i >> j) & 1) == 1) {
-				execute_callback(board, (*edge)[j].first, (*edge)[j].second, &decrement_count, &possibility_counts);
-			}
-		}
-
-		bool good_possibility = true;
-		for (pair<pair<int, int>, int> p : possibility_counts) { //Check each count
-			if (p.second != 0) {
-				good_possibility = false;
-			}
-		}
-
-		if (good_possibility) { //Good possibility
-			count_possibilities += 1;
-			for (int j = 0; j < edge->size(); j++) { //Increment probability for flag squares on this possibility
-				if (((i >> j) & 1) == 1) {
-					pair<int, int> p = (*edge)[j];
-					m_probabilities[p.first][p.second] += 1;
-					mine_count += 1;
-				}
-			}
-		}
-	}
-
-	cout << count_possibilities << " possibilities found for edge" << endl;
-
-	for (int i = 0; i < edge->size(); i++) { //Adjust probabilities for number of possibilities
-		pair<int, int> p = (*edge)[i];
-		m_probabilities[p.first][p.second] /= count_possibilities;
-		cout << p.first << "," << p.second << ": " << m_probabilities[p.first][p.second] << endl;
-	}
-
-	delete[] good_count;
-
-	return mine_count / count_possibilities;
-}
-
-//Approximation of optimal edge probabilities by splitting constraints for each edge into a subset of constraints
-//Find possibilities for edge squares constrained by each subset
-//Struggles with intersection of multiple subsets (for edges squares relevant to more than one subset)
-double Bot::update_probabilities_sectioned(vector<pair<int, int>>* edge) {
-	int* good_count = new int[NUM_THREADS * edge->size()];
-	int success_count[NUM_THREADS] = { 0 };
-	int flag_count = 0;
-
-	unordered_map<pair<int, int>, int, PairHashStruct> adjacent_counts; //Get constraints
-	for (int i = 0; i < edge->size(); i++) {
-		pair<int, int> p = (*edge)[i];
-		execute_callback(board, p.first, p.second, &insert_into_map, &adjacent_counts);
-
-	}
-	for (pair<pair<int, int>, int> p : adjacent_counts) { //Adjust constraints for existing flags
-		flag_count = 0;
-		execute_callback(board, p.first.first, p.first.second, &count_known_mines, &flag_count);
-		adjacent_counts[p.first] -= flag_count;
-	}
-
-	for (int i = 0; i < edge->size(); i++) { //Zero out probabilities of existing edge squares
-		pair<int, int> p = (*edge)[i];
-		m_probabilities[p.first][p.second] = 0;
-	}
-
-	double mine_count = 0;
-	for (pair<pair<int, int>, int> p : adjacent_counts) { //Approximate mine count of edge
-		mine_count += p.second;
-	}
-
-	//Generate edge subsets
-	unordered_set<pair<int, int>, PairHashStruct>* s_map = new unordered_set <pair<int, int>, PairHashStruct>[adjacent_counts.size()];
-	unordered_set<pair<int, int>, PairHashStruct>* i_map = new unordered_set <pair<int, int>, PairHashStruct>[adjacent_counts.size()];
-	unordered_map<pair<int, int>, unordered_set<pair<int, int>, PairHashStruct>*, PairHashStruct> interior_to_edge_squares_map;
-	unordered_map<pair<int, int>, unordered_set<pair<int, int>, PairHashStruct>*, PairHashStruct> interior_to_interior_squares_map;
-	int ind = 0;
-	for (pair<pair<int, int>, int> p : adjacent_counts) { //Get map of constraints to edge squares
-		execute_callback(board, p.first.first, p.first.second, &build_adjacency_set, &s_map[ind]);
-		interior_to_edge_squares_map[p.first] = &s_map[ind];
-		ind += 1;
-	}
-
-	ind = 0;
-	for (pair<pair<int, int>, int> p : adjacent_counts) { //Get map of interior squares to adjacent interior squares
-		for (pair<int, int> c : *interior_to_edge_squares_map[p.first]) {
-			for (pair<pair<int, int>, int> comp : adjacent_counts) {
-				if (interior_to_edge_squares_map[comp.first]->find(c) != interior_to_edge_squares_map[comp.first]->end() && comp.first != p.first) {
-					i_map[ind].insert(comp.first);
-				}
-			}
-		}
-		interior_to_interior_squares_map[p.first] = &i_map[ind];
-		ind += 1;
-	}
-
-	pair<int, int>* adjacent_ordered = new pair<int, int>[adjacent_counts.size()];
-	ind = 0;
-	for (pair<pair<int, int>, int> p : adjacent_counts) { //Order the unordered map
-		adjacent_ordered[ind] = p.first;
-		ind += 1;
-	}
-
-	//Tree search for subsets satisfying edges size constraint
-	vector<AdjacencyOrderingNode*> adjacency_build_queue;
-	vector<AdjacencyOrderingNode*> roots;
-	for (int i = 0; i < adjacent_counts.size(); i++) { //Initialize vector of root nodes for each constraint
-		AdjacencyOrderingNode* root = new AdjacencyOrderingNode;
-		root->coord = adjacent_ordered[i];
-		root->parent = nullptr;
-		adjacency_build_queue.push_back(root);
-		roots.push_back(root);
-	}
-
-	while (!adjacency_build_queue.empty()) { //Depth first search through the nodes of the tree
-		AdjacencyOrderingNode* node = adjacency_build_queue.back();
-		adjacency_build_queue.pop_back();
-		for (pair<int, int> p : *interior_to_edge_squares_map[node->coord]) { //Add all adjacent edge squares to the edge square set
-			if (node->current_squares.find(p) == node->current_squares.end()) {
-				node->current_squares.insert(p);
-			}
-		}
-		if (node->current_squares.size() > MAX_SIZE) { //Exceeded number of maximum possible edge square, remove node from tree
-			if (node->parent != nullptr) {
-				node->parent->children.erase(find(node->parent->children.begin(), node->parent->children.end(), node));
-			}
-			delete node;
-		}
-		else {
-			for (pair<int, int> p : *interior_to_interior_squares_map[node->coord]) { //Good number of squares, add children to tree
-				if (node->visited.find(p) == node->visited.end()) {
-					AdjacencyOrderingNode *n = new AdjacencyOrderingNode;
-					n->parent = node;
-					for (pair<int, int> v : node->visited) { //Copy visited set
-						n->visited.insert(v);
-					}
-					n->visited.insert(node->coord);
-					for (pair<int, int> c : node->current_squares) { //Copy current square set
-						n->current_squares.insert(c);
-					}
-					n->coord = p;
-					node->children.push_back(n);
-					adjacency_build_queue.push_back(n); //Push to stack
-				}
-			}
-		}
-	}
-
-	//Traverse tree to get the edge squares and constraints for each subset
-	unordered_set<int> existing_traversals;
-	vector<unordered_set<pair<int,int>, PairHashStruct>> adjacent_subsets;
-	for (int i = 0; i < adjacent_counts.size(); i++) { 
-		adjacency_build_queue.push_back(roots[i]);
-	}
-
-	while (!adjacency_build_queue.empty()) {
-		AdjacencyOrderingNode* node = adjacency_build_queue.back();
-		adjacency_build_queue.pop_back();
-		if (node->children.size() == 0) { //Leaf node, add to set
-			node->visited.insert(node->coord);
-			if (existing_traversals.find(hash_set(node->visited)) == existing_traversals.end()) { //Check for duplicate set
-				existing_traversals.insert(hash_set(node->visited));
-				adjacent_subsets.push_back(node->visited);
-			}
-		}
-		else {
-			for (AdjacencyOrderingNode* n : node->children) {
-				adjacency_build_queue.push_back(n); //Search children for non-leaf node
-			}
-		}
-	}
-
-	//Remove subsets
-	for (vector<unordered_set<pair<int, int>, PairHashStruct>>::iterator itr = adjacent_subsets.begin(); itr != adjacent_subsets.end(); itr++) {
-		for (vector<unordered_set<pair<int, int>, PairHashStruct>>::iterator del = itr + 1; del != adjacent_subsets.end(); del++) {
-			if (is_subset(*itr, *del)) {
-				del = adjacent_subsets.erase(del);
-				del--;
-			}
-		}
-	}
-
-	cout << adjacent_subsets.size() << " unique subsets found" << endl;
-
-	//Get edge squares from each constraint subset
-	vector <unordered_set<pair<int, int>, PairHashStruct>*> sub_edges;
-	for (unordered_set<pair<int, int>, PairHashStruct> s : adjacent_subsets) {
-		unordered_set < pair<int, int>, PairHashStruct>* set = new unordered_set < pair<int, int>, PairHashStruct>;
-		for (pair<int, int> p : s) {
-			for (pair<int, int> l : *interior_to_edge_squares_map[p]) {
-				set->insert(l);
-			}
-		}
-		sub_edges.push_back(set);
-	}
-
-	int count_possibilities = 0;
-	unordered_map<pair<int, int>, int, PairHashStruct> correction; //Initialize storage of count of number of subsets an edge square appears in
-	for (pair<pair<int, int>, int> p : adjacent_counts) {
-		correction[p.first] = 0;
-	}
-
-	unordered_set<pair<int, int>, PairHashStruct> subset_union; //Union of all edge squares for subsets
-	for (unordered_set<pair<int, int>, PairHashStruct>* se: sub_edges) {
-		for (pair<int, int> p : *se) {
-			subset_union.insert(p);
-		}
-	}
-	for (vector<pair<int, int>>::iterator itr = edge->begin(); itr != edge->end(); ) { //Remove all edge squares not in subsets from edge (to prevent later changes to probability)
-		if (subset_union.find(*itr) == subset_union.end()) {
-			itr = edge->erase(itr);
-		}
-		else {
-			itr++;
-		}
-	}
-	
-	//Brute force check possibilities for each subset
-	for (int k = 0; k < sub_edges.size(); k++) {
-		vector<pair<int, int>> e;
-		for (pair<int, int> p : *sub_edges[k]) { //Get sub-edge for this subset
-			e.push_back(p);
-		}
-		for (pair<int, int> p : e) { //Increment count for relevant squares
-			correction[p] += 1;
-		}
-
-		unordered_set<pair<int, int>, PairHashStruct> interior = adjacent_subsets[k];
-		count_possibilities = 0;
-		for (int i = 0; i < (int)pow(2, e.size()); i++) { //Check each possibility (exponential time)
-			unordered_map<pair<int, int>, int, PairHashStruct> possibility_counts;
-			for (pair<pair<int, int>, int> p : adjacent_counts) { //Deep copy of adjacent_count
-				possibility_counts[p.first] = p.second;
-			}
-
-			for (int j = 0; j < e.size(); j++) { //Subtract counts if the current possibility has edge square as flag
-				if (((i >> j) & 1) == 1) {
-					execute_callback(board, e[j].first, e[j].second, &decrement_count, &possibility_counts);
-				}
-			}
-
-			bool good_possibility = true;
-			for (pair<int, int> p: interior) { //Check each count
-				if (possibility_counts[p] != 0) {
-					good_possibility = false;
-				}
-			}
-
-			if (good_possibility) { //Good possibility
-				count_possibilities += 1;
-				for (int j = 0; j < e.size(); j++) { //Increment probability for flag squares on this possibility
-					if (((i >> j) & 1) == 1) {
-						pair<int, int> p = e[j];
-						m_probabilities[p.first][p.second] += 1;
-					}
-				}
-			}
-		}
-		cout << count_possibilities << " possibilities found for subset" << endl;
-
-		for (int j = 0; j < e.size(); j++) { //Adjust probabilities
-			pair<int, int> p = e[j];
-			m_probabilities[p.first][p.second] /= count_possibilities;
-		}
-	}
-	for (int j = 0; j < edge->size(); j++){ //Adjust probabilities for frequency
-		pair<int, int> p = (*edge)[j];
-		if (correction[p] != 0) {
-			m_probabilities[p.first][p.second] /= correction[p];
-		}
-		cout << p.first << ", " << p.second << ":  " << m_probabilities[p.first][p.second] << endl;
-	}
-
-	//Cleanup
-	//Cleanup tree
-	for (int i = 0; i < adjacent_counts.size(); i++) {
-		adjacency_build_queue.push_back(roots[i]);
-	}
-
-	while (!adjacency_build_queue.empty()) {
-		AdjacencyOrderingNode* node = adjacency_build_queue.back();
-		adjacency_build_queue.pop_back();
-		if (node->children.size() == 0) { //Delete leaf node
-			if (node->parent != nullptr) {
-				node->parent->children.erase(find(node->parent->children.begin(), node->parent->children.end(), node));
-				if (node->parent->children.size() == 0) {                                     
-					adjacency_build_queue.push_back(node->parent); //Check parent of leaf node also
-				}
-			}
-			delete node;
-		}
-		else {
-			for (AdjacencyOrderingNode* n : node->children) {
-				adjacency_build_queue.push_back(n); //Check children if not leaf node
-			}
-		}
-	}
-	delete[] s_map;
-	delete[] i_map;
-	delete[] good_count;
-	delete[] adjacent_ordered;
-
-	for (int i = 0; i < sub_edges.size(); i++) {
-		delete sub_edges[i];
-	}
-
-	return mine_count / edge->size();
-}
\ No newline at end of file
+#include "bot.h"
+#include "board_view.h"
+#include "util.h"
+#include "pattern_table.h"
+#include "neighbour_table.h"
+#include <iostream>
+#include <sstream>
+#include <unordered_map>
+#include <unordered_set>
+#include <set>
+#include <algorithm>
+#include <vector>
+#include <math.h>
+
+using namespace std;
+
+//Reset bot to initial state
+void Bot::reset() {
+	if (m_probabilities != nullptr) {
+		free();
+	}
+	last_result = CONTINUE;
+	last_tier = SINGLE_SQUARE;
+	move_queue.clear();
+	edge_cache.clear();
+	lookahead_cache.clear();
+	m_confidence.clear();
+	interior_probability = 0;
+	own_memory.peak = 0;
+	max_search_memory = 0;
+	game_stats = GameStats();
+}
+
+//Constructor for default values
+Bot::Bot(){
+	m_probabilities = nullptr;
+	single_square_kernel = &Bot::single_square_search_generic;
+	pairwise_kernel = &Bot::pairwise_search_generic;
+	MAX_SIZE = 10;
+	edge_subset_approximation = true;
+	edge_reduction = false;
+	model_counting = false;
+	endgame_squares = 0;
+	endgame_mines = 0;
+	lookahead_candidates = 0;
+	lookahead_time = 0;
+	guessing = true;
+	verbose = true;
+	time_budget = 0;
+	sample_budget = 0;
+	solution_cache = nullptr;
+	task_pool = nullptr;
+	board = nullptr;
+	search_worker = false;
+	defer_sampling = false;
+	sampling_deferred = false;
+	sectioned_node_budget = SECTIONED_NODE_BUDGET;
+	sectioned_memory_budget = (long long)SECTIONED_MEMORY_BUDGET << 20;
+	cost_model = nullptr;
+	move_target = 0;
+	edge_target = 0;
+	own_memory.live = 0;
+	own_memory.peak = 0;
+	search_memory = &own_memory;
+	max_search_memory = 0;
+	game_stats = GameStats();
+	last_tier = SINGLE_SQUARE;
+	m_rng.seed(0);
+	log_output = &cout;
+}
+
+//Destructor
+Bot::~Bot() {
+	if (m_probabilities != nullptr) {
+		free();
+	}
+	for (Bot* worker : search_workers) {
+		delete worker;
+	}
+	if (!search_worker) {
+		delete task_pool;
+	}
+}
+
+//Set board pointer, copy frequently accessed values to this object
+void Bot::set_board(BoardView* b) {
+	board = b;
+	m_rows = b->get_rows();
+	m_cols = b->get_cols();
+	m_mines = b->get_mines();
+
+	m_probabilities = new double* [m_rows];
+	for (int i = 0; i < m_rows; i++) {
+		m_probabilities[i] = new double[m_cols];
+	}
+	guess_queue.reset(m_rows, m_cols);
+	select_kernels();
+}
+
+//Use the searches specialised at compile time for the standard board sizes, and the generic searches for any other size
+void Bot::select_kernels() {
+	if (m_rows == 9 && m_cols == 9) {
+		single_square_kernel = &Bot::single_square_search_fixed<9, 9>;
+		pairwise_kernel = &Bot::pairwise_search_fixed<9, 9>;
+	}
+	else if (m_rows == 16 && m_cols == 16) {
+		single_square_kernel = &Bot::single_square_search_fixed<16, 16>;
+		pairwise_kernel = &Bot::pairwise_search_fixed<16, 16>;
+	}
+	else if (m_rows == 16 && m_cols == 30) {
+		single_square_kernel = &Bot::single_square_search_fixed<16, 30>;
+		pairwise_kernel = &Bot::pairwise_search_fixed<16, 30>;
+	}
+	else {
+		single_square_kernel = &Bot::single_square_search_generic;
+		pairwise_kernel = &Bot::pairwise_search_generic;
+	}
+}
+
+//Set maximum edge length
+void Bot::set_edge_search_limit(int size) {
+	MAX_SIZE = size;
+}
+
+//Enable/disable approximation
+void Bot::set_edge_subset_approximation(bool approximate) {
+	edge_subset_approximation = approximate;
+}
+
+//Enable/disable reduction of edge constraints by Gaussian elimination before searching
+void Bot::set_edge_reduction(bool reduce) {
+	edge_reduction = reduce;
+}
+
+//Enable/disable exact model counting of edges too large for the brute force search
+void Bot::set_model_counting(bool count) {
+	model_counting = count;
+}
+
+//Set thresholds for solving the whole board exactly: at most the given number of unknown squares and mines left (0 to disable)
+void Bot::set_endgame_thresholds(int squares, int mines) {
+	endgame_squares = squares;
+	endgame_mines = mines;
+}
+
+//Set number of best guesses compared by lookahead (0 or 1 to disable), and time allowed for comparing them in milliseconds
+void Bot::set_lookahead(int candidates, double milliseconds) {
+	lookahead_candidates = candidates;
+	lookahead_time = milliseconds;
+}
+
+//Enable/disable guessing (when disabled, a position requiring a guess returns GUESS_REQUIRED)
+void Bot::set_guessing(bool guess) {
+	guessing = guess;
+}
+
+//Enable/disable logging of each search step
+void Bot::set_verbose(bool verbose_output) {
+	verbose = verbose_output;
+}
+
+//Get maximum edge length
+int Bot::get_edge_search_limit() {
+	return MAX_SIZE;
+}
+
+//Set time budget for each move in milliseconds (0 for no limit)
+//Edges that cannot be searched within the budget fall back to cheaper approximations
+void Bot::set_move_time_budget(double milliseconds) {
+	time_budget = milliseconds;
+}
+
+//Get time budget for each move in milliseconds
+double Bot::get_move_time_budget() {
+	return time_budget;
+}
+
+//Get search tier that produced the last move (or the probabilities used for the last guess)
+SolverTier Bot::get_last_tier() {
+	return last_tier;
+}
+
+//Set number of samples drawn for edges too large to search precisely (0 to disable sampling)
+void Bot::set_sample_budget(int samples) {
+	sample_budget = samples;
+}
+
+//Get number of samples drawn for large edges
+int Bot::get_sample_budget() {
+	return sample_budget;
+}
+
+//Set pattern cache shared across games (nullptr to disable)
+void Bot::set_solution_cache(SolutionCache* cache) {
+	solution_cache = cache;
+}
+
+SolutionCache* Bot::get_solution_cache() {
+	return solution_cache;
+}
+
+//Set number of threads searching independent edges and sub-edges at once (1 to search serially)
+//Results are the same as searching serially, apart from where the time budget runs out
+void Bot::set_search_threads(int threads) {
+	for (Bot* worker : search_workers) {
+		delete worker;
+	}
+	search_workers.clear();
+	delete task_pool;
+	task_pool = threads > 1 ? new TaskPool(threads) : nullptr;
+}
+
+//Get number of threads searching edges at once
+int Bot::get_search_threads() {
+	return task_pool == nullptr ? 1 : task_pool->get_threads();
+}
+
+//Set maximum number of nodes of each sub-edge tree, and memory of the sub-edge trees built at once in megabytes (0 for no limit)
+//A tree reaching either budget stops growing, and its root constraint gets one sub-edge grown greedily instead
+void Bot::set_sectioned_budget(int nodes, int megabytes) {
+	sectioned_node_budget = nodes;
+	sectioned_memory_budget = (long long)megabytes << 20;
+}
+
+//Get peak memory of the sub-edge trees during the last move in bytes
+long long Bot::get_peak_search_memory() {
+	return search_memory->peak;
+}
+
+//Get largest peak memory of the sub-edge trees of any move since the last reset in bytes
+long long Bot::get_max_search_memory() {
+	return max(max_search_memory, (long long)search_memory->peak);
+}
+
+//Set cost model recording the time of each precise search, and the time aimed for per move in milliseconds (0 to only record)
+//With a target, each edge is searched precisely if the model predicts the search fits in its share of the time left, instead of if it is smaller than MAX_SIZE
+void Bot::set_cost_model(CostModel* model, double target_milliseconds) {
+	cost_model = model;
+	move_target = model == nullptr ? 0 : target_milliseconds;
+}
+
+//Get cost model (nullptr if not set)
+CostModel* Bot::get_cost_model() {
+	return cost_model;
+}
+
+//Get time aimed for per move in milliseconds (0 if searches are chosen by MAX_SIZE)
+double Bot::get_move_target() {
+	return move_target;
+}
+
+//Get moves, guesses, largest edge and time of each search since the last reset
+GameStats Bot::get_game_stats() {
+	return game_stats;
+}
+
+//Reseed the generator used for sampling and random guesses (the constructor seeds it with 0, and reset leaves it as it is), so a game plays the same after this in any process
+void Bot::set_random_seed(unsigned seed) {
+	m_rng.seed(seed);
+}
+
+//Hash of every setting changing how the bot plays, to tell whether results were played with the same settings
+unsigned long long Bot::get_settings_hash() {
+	long long settings[] = { MAX_SIZE, edge_subset_approximation, edge_reduction, model_counting, endgame_squares, endgame_mines, lookahead_candidates,
+		(long long)(lookahead_time * 1000), guessing, (long long)(time_budget * 1000), sample_budget, solution_cache != nullptr,
+		sectioned_node_budget, sectioned_memory_budget, cost_model != nullptr, (long long)(move_target * 1000) };
+	unsigned long long hash = 0;
+	for (long long setting : settings) {
+		hash = mix_hash(hash ^ (unsigned long long)setting);
+	}
+	return hash;
+}
+
+//Get 95% confidence interval half-width of a square's probability (0 unless it was sampled)
+double Bot::get_confidence(int i, int j) {
+	unordered_map<pair<int, int>, double, PairHashStruct>::iterator itr = m_confidence.find(make_pair(i, j));
+	if (itr == m_confidence.end()) {
+		return 0;
+	}
+	return itr->second;
+}
+
+//Main method: search for the next optimal move
+MoveResult Bot::select_next_move() {
+	if (check_queue_empty()) return last_result; //See if existing safe move exists
+	chrono::steady_clock::time_point phase_start = chrono::steady_clock::now();
+	move_deadline = chrono::steady_clock::now() + chrono::microseconds((long long)(time_budget * 1000));
+	target_deadline = chrono::steady_clock::now() + chrono::microseconds((long long)(move_target * 1000));
+	start_memory_tracking();
+	if (verbose) *log_output << "No existing move in queue, beginning single square search" << endl;
+	single_square_search(); //Search for safe move/mark flags with single square information
+	last_tier = SINGLE_SQUARE;
+	end_phase(&game_stats.single_square_time, &phase_start);
+	if (check_queue_empty()) return last_result;
+	if (verbose) *log_output << "No single square found, beginning pairwise search" << endl;
+	pairwise_search(); //Compare overlapping constraints
+	last_tier = PAIRWISE;
+	end_phase(&game_stats.pairwise_time, &phase_start);
+	if (check_queue_empty()) return last_result;
+	if (verbose) *log_output << "No pairwise deduction found, beginning edge search" << endl;
+	edge_search(); //Use edge-based search 
+	last_tier = search_tier;
+	end_phase(&game_stats.edge_time, &phase_start);
+	if (check_queue_empty()) return last_result;
+	if (!guessing) return GUESS_REQUIRED; //No deduction possible, leave guessing to the caller
+	if (verbose) *log_output << "Guessing" << endl;
+	MoveResult result = guess_random_square(); //Guess based on probabilities/corner-edge heuristic
+	end_phase(&game_stats.guess_time, &phase_start);
+	return result;
+}
+
+//Add the time since the start of a search to its total in microseconds, starting the next search
+void Bot::end_phase(double* total, chrono::steady_clock::time_point* start) {
+	chrono::steady_clock::time_point now = chrono::steady_clock::now();
+	*total += chrono::duration<double, micro>(now - *start).count();
+	*start = now;
+}
+
+//Search for deductions and probabilities without making any move
+//Proven safe squares are left in the move queue and proven mines are marked on the board
+void Bot::analyze() {
+	move_queue.clear();
+	move_deadline = chrono::steady_clock::now() + chrono::microseconds((long long)(time_budget * 1000));
+	target_deadline = chrono::steady_clock::now() + chrono::microseconds((long long)(move_target * 1000));
+	start_memory_tracking();
+	single_square_search();
+	last_tier = SINGLE_SQUARE;
+	if (move_queue.empty()) {
+		pairwise_search();
+		last_tier = PAIRWISE;
+	}
+	bool found = !move_queue.empty();
+	edge_search(); //Always run for probabilities of every square
+	if (!found) {
+		last_tier = search_tier;
+	}
+}
+
+//Get squares proven safe by the last search that are still unknown
+vector<pair<int, int>> Bot::get_safe_squares() {
+	vector<pair<int, int>> safe;
+	unordered_set<pair<int, int>, PairHashStruct> seen;
+	for (pair<int, int> p : move_queue) {
+		if (!board->is_known(p.first, p.second) && seen.insert(p).second) {
+			safe.push_back(p);
+		}
+	}
+	return safe;
+}
+
+//Free all memory for probability array
+void Bot::free() {
+	for (int i = 0; i < m_rows; i++) {
+		delete[] m_probabilities[i];
+	}
+	delete[] m_probabilities;
+}
+
+//Check if there are any safe moves queued, making the move if it exists
+//This allows us to search in batches, using the safe moves from each batch over several moves
+bool Bot::check_queue_empty() {
+	while (!move_queue.empty()) {
+		pair<int, int> p = move_queue.at(0);
+		move_queue.erase(move_queue.begin());
+		if (!board->is_known(p.first, p.second)) {
+			if (verbose) *log_output << "Safe move found" << endl;
+			game_stats.moves += 1;
+			last_result = board->make_move(p.first, p.second);
+			return true;
+		}
+	}
+	return false;
+}
+
+//Search for safe squares and mines using only those square's constraints
+//Extremely effective when large edges are revealed at decreasing the frequency of expensive edge searches
+void Bot::single_square_search() {
+	(this->*single_square_kernel)();
+}
+
+//Single square search for any board size
+void Bot::single_square_search_generic() {
+	for (int i = 0; i < m_rows; i++) { //Iterate over each square
+		for (int j = 0; j < m_cols; j++) {
+			if (board->is_safe(i, j)) {
+				int known_mines = 0;
+				int open_spaces = 0;
+				execute_callback(board, i, j, &count_known_mines, &known_mines); //Count number of known mines adjacent to square
+				execute_callback(board, i, j, &count_unknown_spaces, &open_spaces); //Count number of open spaces adjacent to square
+
+				if (board->get_count(i, j) == open_spaces + known_mines) { //Each open square is a mine, mark them
+					execute_callback(board, i, j, &mark_as_known_mine, nullptr);
+				}
+				if (board->get_count(i, j) == known_mines) { //No possible mines, square is safe so add to queue
+					execute_callback(board, i, j, &append_to_vector, &move_queue);
+				}
+			}
+		}
+	}
+}
+
+//Search for safe squares and mines by comparing pairs of constraints with overlapping unknown squares
+//If constraint B needs exactly as many more mines than A as it has unknown squares outside of A,
+//all of B's squares outside A are mines and all of A's squares outside B are safe (covers the 1-1 and 1-2 patterns)
+//Repeats until no further deductions are found, so that edge searches only see what these patterns cannot solve
+void Bot::pairwise_search() {
+	(this->*pairwise_kernel)();
+}
+
+//Pairwise search for any board size
+void Bot::pairwise_search_generic() {
+	vector<char> deduced_safe(m_rows * m_cols, 0); //Safe squares already queued, treated as known
+	bool changed = true;
+	while (changed) {
+		changed = false;
+		for (int i = 0; i < m_rows; i++) { //Iterate over each constraint
+			for (int j = 0; j < m_cols; j++) {
+				if (!board->is_safe(i, j)) continue;
+				int remaining_a;
+				unsigned long long a = window_mask(i, j, i, j, &deduced_safe, &remaining_a);
+				if (a == 0) continue;
+				for (int di = -2; di <= 2; di++) { //Only constraints up to two squares away can share unknown squares
+					for (int dj = -2; dj <= 2; dj++) {
+						int bi = i + di;
+						int bj = j + dj;
+						if ((di == 0 && dj == 0) || bi < 0 || bj < 0 || bi >= m_rows || bj >= m_cols || !board->is_safe(bi, bj)) continue;
+						int remaining_b;
+						unsigned long long b = window_mask(bi, bj, i, j, &deduced_safe, &remaining_b);
+						if ((a & b) == 0) continue;
+						unsigned long long only_b = b & ~a;
+						if (remaining_b - remaining_a != popcount64(only_b)) continue;
+						unsigned long long only_a = a & ~b;
+						if ((only_a | only_b) == 0) continue;
+						if (verbose) *log_output << "Pairwise deduction from " << i << "," << j << " and " << bi << "," << bj << endl;
+						changed = true;
+						for (int bit = 0; bit < 49; bit++) { //Mark mines and queue safe squares
+							int si = i + bit / 7 - 3;
+							int sj = j + bit % 7 - 3;
+							if (only_b >> bit & 1) {
+								board->mark_mine(si, sj);
+							}
+							if (only_a >> bit & 1) {
+								deduced_safe[si * m_cols + sj] = 1;
+								move_queue.push_back(pair<int, int>(si, sj));
+							}
+						}
+						a = window_mask(i, j, i, j, &deduced_safe, &remaining_a);
+						if (a == 0) break;
+					}
+					if (a == 0) break;
+				}
+			}
+		}
+	}
+}
+
+//Square states copied from the board by the fixed size searches
+#define FIXED_UNKNOWN 0
+#define FIXED_SAFE 1
+#define FIXED_MINE 2
+#define FIXED_QUEUED 3 //Proven safe and queued, not yet revealed
+
+//Single square search for a board size known at compile time
+//Works on a copy of the square states with the neighbour table instead of calling back through the board for each neighbour,
+//visiting squares in the same order as the generic search so that both queue the same moves
+template <int ROWS, int COLS>
+void Bot::single_square_search_fixed() {
+	constexpr const NeighbourTable<ROWS, COLS>& table = NEIGHBOUR_TABLE<ROWS, COLS>;
+	char states[ROWS * COLS];
+	for (int p = 0; p < ROWS * COLS; p++) {
+		int i = p / COLS;
+		int j = p % COLS;
+		states[p] = board->is_safe(i, j) ? FIXED_SAFE : board->is_marked_mine(i, j) ? FIXED_MINE : FIXED_UNKNOWN;
+	}
+
+	for (int p = 0; p < ROWS * COLS; p++) {
+		if (states[p] != FIXED_SAFE) continue;
+		int known_mines = 0;
+		int open_spaces = 0;
+		for (int k = 0; k < table.counts[p]; k++) {
+			char state = states[table.squares[p][k]];
+			known_mines += state == FIXED_MINE;
+			open_spaces += state == FIXED_UNKNOWN;
+		}
+		int count = board->get_count(p / COLS, p % COLS);
+		if (count == open_spaces + known_mines) { //Each open square is a mine, mark them
+			for (int k = 0; k < table.counts[p]; k++) {
+				int n = table.squares[p][k];
+				if (states[n] == FIXED_UNKNOWN) {
+					board->mark_mine(n / COLS, n % COLS);
+					states[n] = FIXED_MINE;
+				}
+			}
+		}
+		if (count == known_mines) { //No possible mines, square is safe so add to queue
+			for (int k = 0; k < table.counts[p]; k++) {
+				int n = table.squares[p][k];
+				if (states[n] == FIXED_UNKNOWN) {
+					move_queue.push_back(pair<int, int>(n / COLS, n % COLS));
+				}
+			}
+		}
+	}
+}
+
+//Pairwise search for a board size known at compile time, on a copy of the square states like the fixed single square search
+template <int ROWS, int COLS>
+void Bot::pairwise_search_fixed() {
+	constexpr const NeighbourTable<ROWS, COLS>& table = NEIGHBOUR_TABLE<ROWS, COLS>;
+	char states[ROWS * COLS];
+	int counts[ROWS * COLS];
+	for (int p = 0; p < ROWS * COLS; p++) {
+		int i = p / COLS;
+		int j = p % COLS;
+		states[p] = board->is_safe(i, j) ? FIXED_SAFE : board->is_marked_mine(i, j) ? FIXED_MINE : FIXED_UNKNOWN;
+		counts[p] = states[p] == FIXED_SAFE ? board->get_count(i, j) : 0;
+	}
+
+	//Unknown squares adjacent to constraint p as a bitmask over the 7x7 window centered on c, with the mines still to be placed among them
+	auto window_mask_fixed = [&](int p, int c, int* remaining) {
+		unsigned long long mask = 0;
+		*remaining = counts[p];
+		for (int k = 0; k < table.counts[p]; k++) {
+			int n = table.squares[p][k];
+			if (states[n] == FIXED_MINE) {
+				(*remaining)--;
+			}
+			else if (states[n] == FIXED_UNKNOWN) {
+				mask |= 1ULL << ((n / COLS - c / COLS + 3) * 7 + n % COLS - c % COLS + 3);
+			}
+		}
+		return mask;
+	};
+
+	bool changed = true;
+	while (changed) {
+		changed = false;
+		for (int p = 0; p < ROWS * COLS; p++) { //Iterate over each constraint
+			if (states[p] != FIXED_SAFE) continue;
+			int i = p / COLS;
+			int j = p % COLS;
+			int remaining_a;
+			unsigned long long a = window_mask_fixed(p, p, &remaining_a);
+			if (a == 0) continue;
+			for (int di = -2; di <= 2; di++) { //Only constraints up to two squares away can share unknown squares
+				for (int dj = -2; dj <= 2; dj++) {
+					int bi = i + di;
+					int bj = j + dj;
+					if ((di == 0 && dj == 0) || bi < 0 || bj < 0 || bi >= ROWS || bj >= COLS || states[bi * COLS + bj] != FIXED_SAFE) continue;
+					int remaining_b;
+					unsigned long long b = window_mask_fixed(bi * COLS + bj, p, &remaining_b);
+					if ((a & b) == 0) continue;
+					unsigned long long only_b = b & ~a;
+					if (remaining_b - remaining_a != popcount64(only_b)) continue;
+					unsigned long long only_a = a & ~b;
+					if ((only_a | only_b) == 0) continue;
+					if (verbose) *log_output << "Pairwise deduction from " << i << "," << j << " and " << bi << "," << bj << endl;
+					changed = true;
+					for (int bit = 0; bit < 49; bit++) { //Mark mines and queue safe squares
+						int si = i + bit / 7 - 3;
+						int sj = j + bit % 7 - 3;
+						if (only_b >> bit & 1) {
+							board->mark_mine(si, sj);
+							states[si * COLS + sj] = FIXED_MINE;
+						}
+						if (only_a >> bit & 1) {
+							states[si * COLS + sj] = FIXED_QUEUED;
+							move_queue.push_back(pair<int, int>(si, sj));
+						}
+					}
+					a = window_mask_fixed(p, p, &remaining_a);
+					if (a == 0) break;
+				}
+				if (a == 0) break;
+			}
+		}
+	}
+}
+
+//Get unknown squares adjacent to constraint (i, j) as a bitmask over the 7x7 window centered on (ci, cj)
+//Sets remaining to the number of mines still to be placed among them
+unsigned long long Bot::window_mask(int i, int j, int ci, int cj, vector<char>* deduced_safe, int* remaining) {
+	unsigned long long mask = 0;
+	*remaining = board->get_count(i, j);
+	for (int d = 0; d < 8; d++) {
+		int ni = i + DIRECTIONS[d][0];
+		int nj = j + DIRECTIONS[d][1];
+		if (ni < 0 || nj < 0 || ni >= m_rows || nj >= m_cols) continue;
+		if (board->is_marked_mine(ni, nj)) {
+			(*remaining)--;
+		}
+		else if (!board->is_known(ni, nj) && !(*deduced_safe)[ni * m_cols + nj]) {
+			mask |= 1ULL << ((ni - ci + 3) * 7 + nj - cj + 3);
+		}
+	}
+	return mask;
+}
+
+//Guesses best probability move available
+//Probabilities are not updated each move, but will occur before any guess (due to edge search)
+//Uses heuristic of being closest to the edges/corners to try to avoid 50/50 guesses near end of game
+//(ties are broken by the spiral order of the guess queue)
+//With lookahead enabled, the best few guesses are compared by their chance of surviving and then making progress instead
+MoveResult Bot::guess_random_square() {
+	pair<int, int> best_guess;
+	double min_probability;
+	if (!guess_queue.best_guess(board, &best_guess, &min_probability)) { //Every square is known without the game being won, so a safe square was marked as a mine
+		if (verbose) *log_output << "No unknown squares left to guess" << endl;
+		last_result = LOSS;
+		return last_result;
+	}
+	if (verbose) *log_output << "Best probability move: " << (1 - min_probability) * 100 << "%" << endl;
+	if (lookahead_candidates > 1) {
+		best_guess = lookahead_guess(best_guess);
+	}
+	game_stats.moves += 1;
+	game_stats.guesses += 1;
+	return board->make_move(best_guess.first, best_guess.second);
+}
+
+//Evaluate the best guesses in order until the lookahead time runs out, returning the best guess evaluated
+//Each guess is scored by the chance it is safe, times the chance that the number it reveals either
+//proves some nearby square safe or a mine, or otherwise leaves a safe next guess
+pair<int, int> Bot::lookahead_guess(pair<int, int> best_guess) {
+	chrono::steady_clock::time_point deadline = chrono::steady_clock::now() + chrono::microseconds((long long)(lookahead_time * 1000));
+	vector<pair<int, int>> candidates = guess_queue.best_guesses(board, lookahead_candidates);
+	double best_score = -1;
+	int evaluated = 0;
+	for (pair<int, int> c : candidates) {
+		if (evaluated > 0 && (chrono::steady_clock::now() > deadline || get_probability(c.first, c.second) > get_probability(best_guess.first, best_guess.second) + LOOKAHEAD_MARGIN)) {
+			break;
+		}
+		double score = lookahead_score(c, deadline);
+		if (score < 0) { //Out of time
+			break;
+		}
+		evaluated++;
+		if (verbose) *log_output << "Lookahead " << c.first << "," << c.second << ": " << (1 - get_probability(c.first, c.second)) * 100 << "% safe, " << score * 100 << "% safe with progress" << endl;
+		if (score > best_score) {
+			best_score = score;
+			best_guess = c;
+		}
+	}
+	if (verbose) *log_output << "Lookahead evaluated " << evaluated << " of " << candidates.size() << " guesses" << endl;
+	return best_guess;
+}
+
+//Score a guess by counting the possibilities of the squares around it for each number it could reveal
+//Only unknown squares linked to the guess through at most LOOKAHEAD_REGION squares are included, with constraints reaching outside them dropped
+//Possibilities are weighted by the interior probability for each mine, and scores are memoised by the guess and its surroundings
+//Returns -1 if the deadline passes
+double Bot::lookahead_score(pair<int, int> guess, chrono::steady_clock::time_point deadline) {
+	vector<pair<int, int>> region; //Guess, its unknown neighbours, then squares sharing constraints with them
+	unordered_map<pair<int, int>, int, PairHashStruct> square_index;
+	square_index[guess] = 0;
+	region.push_back(guess);
+	vector<pair<int, int>> neighbours;
+	execute_callback(board, guess.first, guess.second, &append_to_vector, &neighbours);
+	for (pair<int, int> p : neighbours) {
+		square_index[p] = region.size();
+		region.push_back(p);
+	}
+	for (int k = 0; k < region.size() && region.size() < LOOKAHEAD_REGION; k++) {
+		unordered_map<pair<int, int>, int, PairHashStruct> adjacent;
+		execute_callback(board, region[k].first, region[k].second, &insert_into_map, &adjacent);
+		for (pair<pair<int, int>, int> c : adjacent) {
+			vector<pair<int, int>> unknown;
+			execute_callback(board, c.first.first, c.first.second, &append_to_vector, &unknown);
+			for (pair<int, int> u : unknown) {
+				if (square_index.find(u) == square_index.end() && region.size() < LOOKAHEAD_REGION) {
+					square_index[u] = region.size();
+					region.push_back(u);
+				}
+			}
+		}
+	}
+
+	double density = min(max(interior_probability, 0.01), 0.99);
+	unsigned long long key = hash_edge(board, &region) * 31 + (unsigned long long)(density * 1e6) * 7 + guess.first * m_cols + guess.second;
+	unordered_map<unsigned long long, double>::iterator cached = lookahead_cache.find(key);
+	if (cached != lookahead_cache.end()) {
+		return cached->second;
+	}
+
+	//Constraints entirely within the region, with the guess known to be safe
+	unordered_map<pair<int, int>, int, PairHashStruct> adjacent_counts;
+	for (pair<int, int> p : region) {
+		execute_callback(board, p.first, p.second, &insert_into_map, &adjacent_counts);
+	}
+	vector<CountConstraint> constraints;
+	for (pair<pair<int, int>, int> p : adjacent_counts) {
+		int flag_count = 0;
+		execute_callback(board, p.first.first, p.first.second, &count_known_mines, &flag_count);
+		vector<pair<int, int>> unknown;
+		execute_callback(board, p.first.first, p.first.second, &append_to_vector, &unknown);
+		CountConstraint c;
+		c.remaining = p.second - flag_count;
+		for (pair<int, int> u : unknown) {
+			if (square_index.find(u) == square_index.end()) {
+				c.squares.clear();
+				break;
+			}
+			if (u != guess) {
+				c.squares.push_back(square_index[u] - 1);
+			}
+		}
+		if (!c.squares.empty()) {
+			constraints.push_back(c);
+		}
+	}
+	int guess_flags = 0;
+	execute_callback(board, guess.first, guess.second, &count_known_mines, &guess_flags);
+
+	//Count possibilities for each number the guess could reveal
+	double weight = density / (1 - density);
+	double total = 0;
+	double progress = 0;
+	vector<double> counts;
+	vector<double> histogram;
+	for (int v = guess_flags; v <= guess_flags + (int)neighbours.size(); v++) {
+		CountConstraint revealed;
+		for (int k = 1; k <= neighbours.size(); k++) {
+			revealed.squares.push_back(k - 1);
+		}
+		revealed.remaining = v - guess_flags;
+		constraints.push_back(revealed);
+		model_counter.set_deadline(deadline, true);
+		bool counted = model_counter.count(region.size() - 1, &constraints, &counts, &histogram);
+		constraints.pop_back();
+		if (!counted) {
+			return -1;
+		}
+
+		double possibilities = 0;
+		double weighted = 0;
+		for (int k = 0; k < histogram.size(); k++) {
+			possibilities += histogram[k];
+			weighted += histogram[k] * pow(weight, k);
+		}
+		if (possibilities == 0) {
+			continue;
+		}
+		double min_probability = 1;
+		bool determined = false;
+		for (double count : counts) {
+			determined = determined || count == 0 || count == possibilities;
+			min_probability = min(min_probability, count / possibilities);
+		}
+		total += weighted;
+		progress += weighted * (determined ? 1 : 1 - min_probability);
+	}
+
+	double score = total > 0 ? (1 - get_probability(guess.first, guess.second)) * progress / total : 0;
+	lookahead_cache[key] = score;
+	return score;
+}
+
+//Get probability of a square being a mine from the last edge search
+double Bot::get_probability(int i, int j) {
+	if (guess_queue.is_edge(i, j)) {
+		return m_probabilities[i][j];
+	}
+	return interior_probability;
+}
+
+//Get the k best guesses from the last edge search, best first
+vector<pair<int, int>> Bot::get_best_guesses(int k) {
+	return guess_queue.best_guesses(board, k);
+}
+
+//Indepth search of each edge for all possibilities with given constraints
+//Will select best probability move and find any safe squares/guaranteed mines
+//May approximate for long edges
+void Bot::edge_search() {
+	vector<vector<pair<int, int>>*>* edges = get_edges();
+
+	double count_known = board->get_mines_marked(); //Number of marked mines
+	double count_tot = m_rows * m_cols - board->get_squares_revealed() - count_known; //Number of unknown squares
+	double count_edge = 0;
+	unordered_set<pair<int, int>, PairHashStruct> edge_squares; //Squares of every edge, including any sectioned search drops below
+	for (int i = 0; i < edges->size(); i++) { //Count total number of squares in edges
+		count_edge += (*edges)[i]->size();
+		game_stats.largest_edge = max(game_stats.largest_edge, (int)(*edges)[i]->size());
+		edge_squares.insert((*edges)[i]->begin(), (*edges)[i]->end());
+	}
+
+	//Update probabilities of each edge, splitting remaining time evenly between remaining edges
+	//Edges untouched since the last search (same squares, constraints and remaining counts) reuse their cached solution
+	//Near the end of the game, the whole board is instead solved exactly as one problem with the global mine count
+	double edge_mines = 0;
+	double min_edge_mines = 0; //Bounds on the mines in the edges over every possibility, for deciding the interior
+	double max_edge_mines = 0;
+	search_tier = PRECISE;
+	unordered_map<unsigned long long, EdgeSolution> next_cache;
+	vector<pair<int, int>> updated_squares;
+	bool endgame = count_tot <= endgame_squares && m_mines - count_known <= endgame_mines && endgame_search(edges, &updated_squares);
+
+	//With a task pool, edges missing from the cache are searched at once first, and their solutions are taken in edge order below
+	vector<unsigned long long> fingerprints;
+	vector<EdgeSolution> solutions(edges->size());
+	vector<char> searched(edges->size(), 0);
+	vector<int> pending;
+	vector<vector<double>> probabilities(edges->size());
+	vector<string> logs(edges->size());
+
+	//Sampled solutions weigh possibilities by the ways to place the mines left outside the edge, so they are only reused
+	//with the same mines left, unknown squares and sample budget, while estimates (made when out of time) are never reused
+	unsigned long long sampled_state = mix_hash(((unsigned long long)(m_mines - count_known) << 32) ^ ((unsigned long long)count_tot << 16) ^ sample_budget);
+	auto find_cached = [&](unsigned long long fingerprint) {
+		unordered_map<unsigned long long, EdgeSolution>::iterator cached = edge_cache.find(fingerprint);
+		return cached != edge_cache.end() ? cached : edge_cache.find(fingerprint ^ sampled_state);
+	};
+	auto add_bounds = [&](const EdgeSolution& solution, int edge_size) { //Edges without a histogram could hold anywhere from no mines to all of their squares
+		const vector<double>& histogram = solution.histogram;
+		int low = 0;
+		int high = histogram.empty() ? edge_size : histogram.size() - 1;
+		while (low < high && low < histogram.size() && histogram[low] == 0) low++;
+		while (high > low && !histogram.empty() && histogram[high] == 0) high--;
+		min_edge_mines += low;
+		max_edge_mines += high;
+	};
+	for (int i = 0; !endgame && i < edges->size(); i++) {
+		fingerprints.push_back(hash_edge(board, (*edges)[i]));
+		if (find_cached(fingerprints[i]) == edge_cache.end()) {
+			pending.push_back(i);
+		}
+	}
+	if (task_pool != nullptr && pending.size() > 1) {
+		search_edges_parallel(edges, &pending, &solutions, &searched, &probabilities, &logs);
+	}
+
+	for (int i = 0; !endgame && i < edges->size(); i++) {
+		vector<pair<int, int>>* edge = (*edges)[i];
+		int edge_size = edge->size(); //Before sectioned search drops any squares
+		unsigned long long fingerprint = fingerprints[i];
+		unordered_map<unsigned long long, EdgeSolution>::iterator cached = find_cached(fingerprint);
+		if (cached != edge_cache.end()) {
+			EdgeSolution& solution = cached->second;
+			if (verbose) *log_output << "Edge unchanged, reusing " << solution.squares.size() << " square solution" << endl;
+			*edge = solution.squares; //Sectioned search may have dropped squares from the edge
+			for (int j = 0; j < solution.squares.size(); j++) {
+				pair<int, int> p = solution.squares[j];
+				if (solution.confidence[j] > 0) {
+					m_confidence[p] = solution.confidence[j];
+				}
+			}
+			search_tier = max(search_tier, solution.tier);
+			edge_mines += solution.mine_count;
+			add_bounds(solution, edge_size);
+			next_cache[cached->first] = solution;
+			continue;
+		}
+
+		set_edge_deadline(1.0 / (edges->size() - i));
+		set_edge_target(1.0 / (edges->size() - i));
+		SolverTier previous_tier = search_tier;
+		search_tier = PRECISE;
+		edge_histogram.clear();
+		EdgeSolution solution;
+		if (searched[i]) { //Take the worker's solution as if this edge had just been searched
+			if (verbose) *log_output << logs[i];
+			for (pair<int, int> p : *edge) { //Squares dropped by sectioned search were zeroed
+				m_probabilities[p.first][p.second] = 0;
+			}
+			*edge = solutions[i].squares;
+			for (int j = 0; j < edge->size(); j++) {
+				m_probabilities[(*edge)[j].first][(*edge)[j].second] = probabilities[i][j];
+			}
+			search_tier = solutions[i].tier;
+			edge_histogram = solutions[i].histogram;
+			solution.mine_count = solutions[i].mine_count;
+		}
+		else {
+			solution.mine_count = update_probabilities(edge);
+		}
+		solution.tier = search_tier;
+		solution.histogram = edge_histogram;
+		solution.squares = *edge;
+		for (pair<int, int> p : *edge) {
+			solution.confidence.push_back(get_confidence(p.first, p.second));
+			updated_squares.push_back(p);
+		}
+		search_tier = max(previous_tier, solution.tier);
+		edge_mines += solution.mine_count;
+		add_bounds(solution, edge_size);
+		if (solution.tier == SAMPLED) {
+			next_cache[fingerprint ^ sampled_state] = solution;
+		}
+		else if (solution.tier != ESTIMATE) {
+			next_cache[fingerprint] = solution;
+		}
+	}
+	for (unordered_map<unsigned long long, EdgeSolution>::iterator itr = edge_cache.begin(); itr != edge_cache.end(); itr++) { //Confidence of edges that changed is stale
+		if (next_cache.find(itr->first) == next_cache.end()) {
+			for (pair<int, int> p : itr->second.squares) {
+				m_confidence.erase(p);
+			}
+		}
+	}
+	edge_cache.swap(next_cache);
+
+	unordered_set<pair<int, int>, PairHashStruct> in_edges;
+	for (vector<pair<int, int>>* v : *edges) { //Copy edges to set for faster search
+		for (pair<int, int> p : *v) {
+			in_edges.insert(p);
+		}
+	}
+
+	//Only the interior probability is recomputed for all other squares
+	if (endgame) { //Already exact
+	}
+	else if (m_mines - count_known - edge_mines == count_tot - count_edge) { //More primitive approximation
+		interior_probability = (m_mines - count_known) / (count_tot);
+	}
+	else { //Better approximation
+		interior_probability = (m_mines - count_known - edge_mines) / (count_tot - count_edge);
+	}
+
+	//Update guess priorities, only touching edge squares that changed
+	for (pair<int, int> p : guess_queue.edge_squares()) { //Squares dropped from edges (by sectioned search) share the interior probability
+		if (in_edges.find(p) == in_edges.end()) {
+			guess_queue.set_interior(p.first, p.second);
+		}
+	}
+	for (pair<int, int> p : updated_squares) {
+		if (in_edges.find(p) != in_edges.end()) {
+			guess_queue.update(p.first, p.second, m_probabilities[p.first][p.second]);
+		}
+	}
+	guess_queue.set_interior_probability(interior_probability);
+
+	for (vector<pair<int, int>>* v : *edges) { //Mark all known mines, add all safe edges
+		for (pair<int, int> p : *v) {
+			if (m_probabilities[p.first][p.second] == 0.0) {
+				move_queue.push_back(p);
+			}
+			if (m_probabilities[p.first][p.second] == 1.0 && !board->is_known(p.first, p.second)) {
+				board->mark_mine(p.first, p.second);
+			}
+		}
+	}
+	//The interior is only determined if every possibility of the edges leaves no mines (or only mines) for it
+	//The bounds cover every edge searched or reused this move, and squares dropped by sectioned search stay out of the interior
+	bool interior_determined = endgame && (interior_probability == 0.0 || interior_probability == 1.0);
+	if (!endgame && count_tot > count_edge) {
+		if (m_mines - count_known - min_edge_mines <= 0) {
+			interior_probability = 0;
+			interior_determined = true;
+		}
+		else if (m_mines - count_known - max_edge_mines >= count_tot - count_edge) {
+			interior_probability = 1;
+			interior_determined = true;
+		}
+		guess_queue.set_interior_probability(interior_probability);
+	}
+	if (interior_determined) { //Every interior square is determined
+		for (int i = 0; i < m_rows; i++) {
+			for (int j = 0; j < m_cols; j++) {
+				if (board->is_known(i, j) || edge_squares.find(make_pair(i, j)) != edge_squares.end()) {
+					continue;
+				}
+				if (interior_probability == 0.0) {
+					move_queue.push_back(make_pair(i, j));
+				}
+				else {
+					board->mark_mine(i, j);
+				}
+			}
+		}
+	}
+
+	while (!edges->empty()) { //Cleanup
+		delete edges->back();
+		edges->pop_back();
+	}
+	delete edges;
+}
+
+//Search the given edges at once on the task pool, one worker bot per thread, each solution written to its edge's slot
+//Edges whose search reaches the sampling search are left unsearched, so the owner samples them in order with its own random number generator
+void Bot::search_edges_parallel(vector<vector<pair<int, int>>*>* edges, vector<int>* pending, vector<EdgeSolution>* solutions, vector<char>* searched, vector<vector<double>>* probabilities, vector<string>* logs) {
+	prepare_search_workers();
+	set_edge_deadline(min(1.0, (double)task_pool->get_threads() / pending->size()));
+	set_edge_target(min(1.0, (double)task_pool->get_threads() / pending->size()));
+	chrono::steady_clock::time_point deadline = edge_deadline;
+	task_pool->run(pending->size(), [&](int k) {
+		int i = (*pending)[k];
+		Bot* worker = search_workers[task_pool->get_thread_index()];
+		vector<pair<int, int>> edge = *(*edges)[i];
+		worker->edge_deadline = deadline;
+		worker->edge_target = edge_target;
+		worker->search_tier = PRECISE;
+		worker->edge_histogram.clear();
+		worker->sampling_deferred = false;
+		ostringstream output;
+		ostream* previous_log = worker->log_output; //Restored in case this task ran while the worker waited for its own tasks
+		worker->log_output = &output;
+		double mine_count = worker->update_probabilities(&edge);
+		worker->log_output = previous_log;
+		if (worker->sampling_deferred) {
+			return;
+		}
+		(*logs)[i] = output.str();
+		EdgeSolution& solution = (*solutions)[i];
+		solution.mine_count = mine_count;
+		solution.tier = worker->search_tier;
+		solution.histogram = worker->edge_histogram;
+		solution.squares = edge;
+		for (pair<int, int> p : edge) {
+			(*probabilities)[i].push_back(worker->m_probabilities[p.first][p.second]);
+		}
+		(*searched)[i] = 1;
+	});
+}
+
+//Create a worker bot for each thread of the task pool, and bring their board and settings up to date with this bot
+void Bot::prepare_search_workers() {
+	while (search_workers.size() < task_pool->get_threads()) {
+		Bot* worker = new Bot();
+		worker->search_worker = true;
+		search_workers.push_back(worker);
+	}
+	for (Bot* worker : search_workers) {
+		if (worker->board != board || worker->m_rows != m_rows || worker->m_cols != m_cols || worker->m_mines != m_mines) {
+			worker->reset();
+			worker->set_board(board);
+		}
+		worker->MAX_SIZE = MAX_SIZE;
+		worker->edge_subset_approximation = edge_subset_approximation;
+		worker->edge_reduction = edge_reduction;
+		worker->model_counting = model_counting;
+		worker->guessing = guessing;
+		worker->verbose = verbose;
+		worker->time_budget = time_budget;
+		worker->sample_budget = sample_budget;
+		worker->solution_cache = solution_cache;
+		worker->task_pool = task_pool;
+		worker->sectioned_node_budget = sectioned_node_budget;
+		worker->sectioned_memory_budget = sectioned_memory_budget;
+		worker->search_memory = search_memory;
+		worker->cost_model = cost_model;
+		worker->move_target = move_target;
+		worker->defer_sampling = true;
+		worker->move_deadline = move_deadline;
+	}
+}
+
+//Start tracking the peak memory of a new move, keeping the largest peak of the moves before it
+void Bot::start_memory_tracking() {
+	max_search_memory = max(max_search_memory, (long long)search_memory->peak);
+	search_memory->peak = 0;
+}
+
+//Count bytes allocated (or freed, if negative) by a search, raising the peak of the move if needed
+void Bot::track_memory(long long bytes) {
+	long long live = search_memory->live += bytes;
+	long long peak = search_memory->peak;
+	while (live > peak && !search_memory->peak.compare_exchange_weak(peak, live)) {
+	}
+}
+
+//Run tasks on the task pool if there is one, otherwise one after another
+void Bot::run_tasks(int num_tasks, const function<void(int)>& task) {
+	if (task_pool != nullptr) {
+		task_pool->run(num_tasks, task);
+		return;
+	}
+	for (int i = 0; i < num_tasks; i++) {
+		task(i);
+	}
+}
+
+//Exact search of every unknown square at once, with a constraint for the number of mines left on the board
+//Sets probabilities of edge squares and the interior probability, returns false if counting runs out of time
+bool Bot::endgame_search(vector<vector<pair<int, int>>*>* edges, vector<pair<int, int>>* updated_squares) {
+	vector<pair<int, int>> squares; //Edge squares, then interior squares
+	unordered_map<pair<int, int>, int, PairHashStruct> square_index;
+	for (vector<pair<int, int>>* edge : *edges) {
+		for (pair<int, int> p : *edge) {
+			square_index[p] = squares.size();
+			squares.push_back(p);
+		}
+	}
+	int count_edge = squares.size();
+	for (int i = 0; i < m_rows; i++) {
+		for (int j = 0; j < m_cols; j++) {
+			if (!board->is_known(i, j) && square_index.find(make_pair(i, j)) == square_index.end()) {
+				square_index[make_pair(i, j)] = squares.size();
+				squares.push_back(make_pair(i, j));
+			}
+		}
+	}
+	if (verbose) *log_output << "Endgame: solving " << squares.size() << " unknown squares exactly" << endl;
+
+	EdgeLayout layout; //Get constraints
+	build_layout(&squares, count_edge, &layout);
+	vector<CountConstraint> constraints(layout.remaining.size());
+	for (int c = 0; c < constraints.size(); c++) {
+		constraints[c].squares.assign(layout.constraint_squares.begin() + layout.constraint_start[c], layout.constraint_squares.begin() + layout.constraint_start[c + 1]);
+		constraints[c].remaining = layout.remaining[c];
+	}
+	CountConstraint global; //Every mine left is on one of the unknown squares
+	for (int i = 0; i < squares.size(); i++) {
+		global.squares.push_back(i);
+	}
+	global.remaining = m_mines - board->get_mines_marked();
+	constraints.push_back(global);
+
+	vector<double> counts;
+	vector<double> histogram;
+	model_counter.set_deadline(move_deadline, time_budget > 0);
+	if (!model_counter.count(squares.size(), &constraints, &counts, &histogram)) {
+		if (verbose) *log_output << "Endgame search stopped after " << model_counter.get_nodes() << " branches" << endl;
+		return false;
+	}
+	double count_possibilities = 0;
+	for (double h : histogram) {
+		count_possibilities += h;
+	}
+	if (count_possibilities == 0) {
+		return false;
+	}
+	if (verbose) *log_output << count_possibilities << " possibilities found for board in " << model_counter.get_nodes() << " branches" << endl;
+
+	for (int i = 0; i < count_edge; i++) {
+		pair<int, int> p = squares[i];
+		m_probabilities[p.first][p.second] = counts[i] / count_possibilities;
+		updated_squares->push_back(p);
+		if (verbose) *log_output << p.first << "," << p.second << ": " << m_probabilities[p.first][p.second] << endl;
+	}
+	if (squares.size() > count_edge) { //Interior squares are interchangeable, so all have the same probability
+		interior_probability = counts[count_edge] / count_possibilities;
+	}
+	return true;
+}
+
+//Returns vector of vector of pairs, each vector of pairs representing an edge
+//In this context, an edge is any set of unknown squares sharing a common set of constraints
+//Squares are labelled in one breadth first pass over flat ids (row * columns + column), queueing each unknown square at most once for each adjacent known square
+vector<vector<pair<int, int>>*>* Bot::get_edges() { //Returns vector of edges (each edge is a vector of pairs representing a square along that edge)
+	int size = m_rows * m_cols;
+	vector<char> known(size);
+	for (int i = 0; i < m_rows; i++) {
+		for (int j = 0; j < m_cols; j++) {
+			known[i * m_cols + j] = board->is_known(i, j);
+		}
+	}
+	vector<char> visited(size, 0);
+	vector<vector<pair<int, int>>*>* vec = new vector<vector<pair<int, int>>*>;
+	vector<int> search_queue;
+
+	for (int s = 0; s < size; s++) { //Iterate over each square
+		if (visited[s] || known[s]) { //Only consider non-visited and unknown squares
+			continue;
+		}
+		search_queue.clear();
+		search_queue.push_back(s);
+		vector<pair<int, int>>* edge = new vector<pair<int, int>>;
+		for (int head = 0; head < search_queue.size(); head++) { //Loop through search queue
+			int t = search_queue[head];
+			if (visited[t]) { //Check that square hasn't been put in current edge already
+				continue;
+			}
+			int ti = t / m_cols;
+			int tj = t % m_cols;
+			bool constrained = false;
+			for (int k = 0; k < 8; k++) { //Queue unknown squares around each adjacent known square not yet visited
+				int ki = ti + DIRECTIONS[k][0];
+				int kj = tj + DIRECTIONS[k][1];
+				if (ki < 0 || ki >= m_rows || kj < 0 || kj >= m_cols || !known[ki * m_cols + kj]) {
+					continue;
+				}
+				constrained = true;
+				int kid = ki * m_cols + kj;
+				if (!visited[kid]) {
+					for (int l = 0; l < 8; l++) {
+						int ui = ki + DIRECTIONS[l][0];
+						int uj = kj + DIRECTIONS[l][1];
+						if (ui >= 0 && ui < m_rows && uj >= 0 && uj < m_cols && !known[ui * m_cols + uj] && !visited[ui * m_cols + uj]) {
+							search_queue.push_back(ui * m_cols + uj);
+						}
+					}
+					visited[kid] = 1;
+				}
+			}
+			if (constrained) {
+				edge->push_back(make_pair(ti, tj));
+			}
+			visited[t] = 1; //Mark each visited square
+		}
+		if (!edge->empty()) { //Add edge to list of edges
+			vec->push_back(edge);
+		}
+		else {
+			delete edge;
+		}
+	}
+
+	return vec;
+}
+
+//Builds the compact form of the given squares, with the constraints adjacent to the first constrained squares in the order they are first reached
+//Unknown squares of a constraint that are not among the given squares are left out of it
+//Runs in time linear with the number of squares, using an index by flat id kept between calls
+void Bot::build_layout(vector<pair<int, int>>* squares, int constrained, EdgeLayout* layout) {
+	if (layout_index.size() != m_rows * m_cols) {
+		layout_index.assign(m_rows * m_cols, -1);
+	}
+	layout->squares.clear();
+	layout->constraint_start.clear();
+	layout->constraint_squares.clear();
+	layout->remaining.clear();
+	for (int i = 0; i < squares->size(); i++) {
+		int id = (*squares)[i].first * m_cols + (*squares)[i].second;
+		layout_index[id] = i;
+		layout->squares.push_back(id);
+	}
+
+	vector<int> constraints; //Flat ids of the constraints
+	for (int i = 0; i < constrained; i++) {
+		pair<int, int> p = (*squares)[i];
+		for (int k = 0; k < 8; k++) {
+			int ci = p.first + DIRECTIONS[k][0];
+			int cj = p.second + DIRECTIONS[k][1];
+			if (ci < 0 || ci >= m_rows || cj < 0 || cj >= m_cols || layout_index[ci * m_cols + cj] >= 0 || !board->is_safe(ci, cj)) {
+				continue;
+			}
+			layout_index[ci * m_cols + cj] = constraints.size();
+			constraints.push_back(ci * m_cols + cj);
+
+			layout->constraint_start.push_back(layout->constraint_squares.size());
+			int remaining = board->get_count(ci, cj);
+			for (int l = 0; l < 8; l++) {
+				int ui = ci + DIRECTIONS[l][0];
+				int uj = cj + DIRECTIONS[l][1];
+				if (ui < 0 || ui >= m_rows || uj < 0 || uj >= m_cols) {
+					continue;
+				}
+				if (board->is_marked_mine(ui, uj)) {
+					remaining -= 1;
+				}
+				else if (!board->is_known(ui, uj) && layout_index[ui * m_cols + uj] >= 0) {
+					layout->constraint_squares.push_back(layout_index[ui * m_cols + uj]);
+				}
+			}
+			layout->remaining.push_back(remaining);
+		}
+	}
+	layout->constraint_start.push_back(layout->constraint_squares.size());
+
+	for (int id : layout->squares) { //Clear the index for the next call
+		layout_index[id] = -1;
+	}
+	for (int id : constraints) {
+		layout_index[id] = -1;
+	}
+}
+
+//Redirect call to update probabilities to appropriate method
+double Bot::update_probabilities(vector<pair<int, int>>* edge) {
+	if (verbose) {
+		*log_output << "Updating probability for edge: ";
+		for (pair<int, int> p : *edge) {
+			*log_output << "(" << p.first << ", " << p.second << ")";
+		}
+		*log_output << endl;
+	}
+
+	//Reduced edges with few enough free squares are searched precisely regardless of their size
+	chrono::steady_clock::time_point deadline = edge_deadline;
+	bool sampling = sample_budget > 0;
+	bool large = !search_precisely(edge);
+	SolverTier tier = PRECISE;
+	double mine_count = -1;
+	if (edge_reduction && edge->size() > PATTERN_SQUARES) {
+		mine_count = update_probabilities_reduced(edge);
+		if (mine_count >= 0) {
+			search_tier = max(search_tier, tier);
+			return mine_count;
+		}
+	}
+	if (model_counting && large) { //Count large edges precisely if they split into small enough components
+		if (sampling || edge_subset_approximation) { //Leave half of the time for the approximation
+			set_edge_deadline(0.5);
+		}
+		mine_count = update_probabilities_counted(edge);
+		edge_deadline = deadline;
+		if (mine_count >= 0) {
+			search_tier = max(search_tier, tier);
+			return mine_count;
+		}
+	}
+
+	if (!guessing && large) { //Only precise deductions are useful without guessing, skip large edges
+		if (verbose) *log_output << "Edge too large, skipping edge search" << endl;
+		edge_histogram.clear();
+		for (pair<int, int> p : *edge) {
+			m_probabilities[p.first][p.second] = 0.5;
+		}
+		search_tier = max(search_tier, ESTIMATE); //Placeholder probabilities, never cached or taken as exact
+		return 0;
+	}
+	//Escalate from precise search to cheaper approximations whenever the edge deadline passes
+	if ((sampling || edge_subset_approximation) && large) {
+		if (sampling) {
+			if (verbose) *log_output << "Edge too large, sampling edge possibilities" << endl;
+			tier = SAMPLED;
+			mine_count = update_probabilities_sampled(edge);
+		}
+		else {
+			if (verbose) *log_output << "Edge too large, using subset edge search" << endl;
+			tier = SECTIONED;
+			mine_count = update_probabilities_sectioned(edge);
+		}
+	}
+	else {
+		if (sampling || edge_subset_approximation) { //Leave half of the time for the approximation
+			set_edge_deadline(0.5);
+		}
+		if (edge->size() <= PATTERN_SQUARES) { //Small edges are solved with table lookups
+			mine_count = update_probabilities_table(edge);
+		}
+		else {
+			mine_count = update_probabilities_cached(edge);
+		}
+		if (mine_count < 0 && sampling) {
+			if (verbose) *log_output << "Edge search out of time, sampling edge possibilities" << endl;
+			edge_deadline = deadline;
+			tier = SAMPLED;
+			mine_count = update_probabilities_sampled(edge);
+		}
+		else if (mine_count < 0 && edge_subset_approximation) {
+			if (verbose) *log_output << "Edge search out of time, using subset edge search" << endl;
+			edge_deadline = deadline;
+			tier = SECTIONED;
+			mine_count = update_probabilities_sectioned(edge);
+		}
+	}
+	if (mine_count < 0) {
+		if (verbose) *log_output << "Edge search out of time, estimating from constraints" << endl;
+		tier = ESTIMATE;
+		mine_count = update_probabilities_estimate(edge);
+	}
+	if (tier != PRECISE) { //Approximations have no histogram (and may follow a precise search that ran out of time)
+		edge_histogram.clear();
+	}
+	search_tier = max(search_tier, tier);
+	return mine_count;
+}
+
+//Set deadline for the next edge as a fraction of the time remaining for this move
+void Bot::set_edge_deadline(double fraction) {
+	chrono::steady_clock::time_point now = chrono::steady_clock::now();
+	if (now >= move_deadline) {
+		edge_deadline = now;
+	}
+	else {
+		edge_deadline = now + chrono::duration_cast<chrono::steady_clock::duration>((move_deadline - now) * fraction);
+	}
+}
+
+//Set the target time of the next edge as a fraction of the move's target time remaining
+void Bot::set_edge_target(double fraction) {
+	double remaining = chrono::duration<double, milli>(target_deadline - chrono::steady_clock::now()).count();
+	edge_target = max(0.0, remaining) * fraction;
+}
+
+//Check if an edge should be searched precisely: if it is smaller than MAX_SIZE, or with a target time per move,
+//if the cost model predicts the search fits in the edge's target time
+bool Bot::search_precisely(vector<pair<int, int>>* edge) {
+	if (move_target <= 0) {
+		return edge->size() < MAX_SIZE;
+	}
+	if (edge->size() <= PATTERN_SQUARES) { //Table lookups take no time to speak of
+		return true;
+	}
+	if (edge->size() > COST_MODEL_MAX_SIZE) {
+		return false;
+	}
+	EdgeLayout layout;
+	build_layout(edge, edge->size(), &layout);
+	double predicted = cost_model->predict(edge->size(), layout.remaining.size());
+	if (verbose) *log_output << "Precise search predicted to take " << predicted << " ms, " << edge_target << " ms left for edge" << endl;
+	return predicted <= edge_target;
+}
+
+//Check if the current edge has run out of time (never true without a time budget)
+bool Bot::past_deadline() {
+	return time_budget > 0 && chrono::steady_clock::now() >= edge_deadline;
+}
+
+//Precise search for edges of up to PATTERN_SQUARES squares using the compile time pattern table
+//Each constraint is one table lookup, giving the same results as the brute force search without checking each possibility
+double Bot::update_probabilities_table(vector<pair<int, int>>* edge) {
+	EdgeLayout layout; //Get constraints
+	build_layout(edge, edge->size(), &layout);
+
+	uint64_t valid = edge->size() == PATTERN_SQUARES ? ~0ULL : (1ULL << (1 << edge->size())) - 1; //Possibilities of squares in the edge
+	for (int c = 0; c < layout.remaining.size(); c++) { //Keep possibilities satisfying each constraint
+		int mask = 0;
+		for (int k = layout.constraint_start[c]; k < layout.constraint_start[c + 1]; k++) {
+			mask |= 1 << layout.constraint_squares[k];
+		}
+		int count = layout.remaining[c];
+		if (count < 0 || count > PATTERN_MAX_COUNT) {
+			valid = 0;
+		}
+		else {
+			valid &= PATTERN_TABLE.constraints[mask][count];
+		}
+	}
+
+	int count_possibilities = popcount64(valid);
+	double mine_count = 0;
+	edge_histogram.assign(edge->size() + 1, 0);
+	for (int k = 0; k <= edge->size(); k++) {
+		edge_histogram[k] = popcount64(valid & PATTERN_TABLE.mines[k]);
+		mine_count += k * edge_histogram[k];
+	}
+	if (verbose) *log_output << count_possibilities << " possibilities found for edge" << endl;
+
+	for (int i = 0; i < edge->size(); i++) {
+		pair<int, int> p = (*edge)[i];
+		m_probabilities[p.first][p.second] = popcount64(valid & PATTERN_TABLE.squares[i]);
+		m_probabilities[p.first][p.second] /= count_possibilities;
+		if (verbose) *log_output << p.first << "," << p.second << ": " << m_probabilities[p.first][p.second] << endl;
+	}
+
+	return mine_count / count_possibilities;
+}
+
+//Greatest common divisor of two row coefficients
+static long long gcd_coefficients(long long a, long long b) {
+	a = a < 0 ? -a : a;
+	b = b < 0 ? -b : b;
+	while (b != 0) {
+		long long t = a % b;
+		a = b;
+		b = t;
+	}
+	return a;
+}
+
+//Precise search after reducing the edge's constraints with Gaussian elimination
+//Each constraint is a row of 0/1 coefficients over the edge squares with its remaining count on the right hand side
+//Rows whose bounds can only be met one way fix their squares, and the reduced rows give each pivot square from the free squares,
+//so only the free squares are enumerated. Returns -1 if the edge has more free squares than the edge search limit (or runs out of time)
+double Bot::update_probabilities_reduced(vector<pair<int, int>>* edge) {
+	int n = edge->size();
+	EdgeLayout layout; //Get constraints
+	build_layout(edge, n, &layout);
+	vector<vector<long long>> rows; //Coefficients of each square followed by the remaining count
+	for (int c = 0; c < layout.remaining.size(); c++) {
+		vector<long long> row(n + 1, 0);
+		for (int k = layout.constraint_start[c]; k < layout.constraint_start[c + 1]; k++) {
+			row[layout.constraint_squares[k]] = 1;
+		}
+		row[n] = layout.remaining[c];
+		rows.push_back(row);
+	}
+
+	vector<int> fixed(n, -1); //Value of squares forced by bounds (-1 if not forced)
+	vector<int> pivot_column;
+	bool consistent = true;
+	bool changed = true;
+	while (changed && consistent) {
+		changed = false;
+
+		//Reduce rows to reduced row echelon form, keeping integer coefficients
+		pivot_column.clear();
+		int r = 0;
+		for (int c = 0; c < n && r < rows.size(); c++) {
+			int pivot = -1;
+			for (int k = r; k < rows.size() && pivot < 0; k++) {
+				if (rows[k][c] != 0) pivot = k;
+			}
+			if (pivot < 0) continue;
+			swap(rows[r], rows[pivot]);
+			for (int k = 0; k < rows.size(); k++) {
+				if (k == r || rows[k][c] == 0) continue;
+				long long a = rows[r][c];
+				long long b = rows[k][c];
+				long long g = 0;
+				for (int m = 0; m <= n; m++) {
+					rows[k][m] = rows[k][m] * a - rows[r][m] * b;
+					g = gcd_coefficients(g, rows[k][m]);
+				}
+				if (g > 1) {
+					for (int m = 0; m <= n; m++) {
+						rows[k][m] /= g;
+					}
+				}
+			}
+			pivot_column.push_back(c);
+			r++;
+		}
+
+		//Fix squares for rows that can only be satisfied one way
+		for (int k = 0; k < rows.size() && consistent; k++) {
+			long long low = 0;
+			long long high = 0;
+			for (int c = 0; c < n; c++) {
+				if (rows[k][c] < 0) low += rows[k][c];
+				else high += rows[k][c];
+			}
+			if (rows[k][n] < low || rows[k][n] > high) {
+				consistent = false;
+			}
+			else if (low != high && (rows[k][n] == low || rows[k][n] == high)) {
+				bool upper = rows[k][n] == high;
+				for (int c = 0; c < n; c++) { //Substitute forced squares into every row
+					if (rows[k][c] == 0) continue;
+					int value = (rows[k][c] > 0) == upper ? 1 : 0;
+					fixed[c] = value;
+					for (int m = 0; m < rows.size(); m++) {
+						if (m == k) continue;
+						rows[m][n] -= rows[m][c] * value;
+						rows[m][c] = 0;
+					}
+				}
+				for (int c = 0; c <= n; c++) {
+					rows[k][c] = 0;
+				}
+				changed = true;
+			}
+		}
+	}
+
+	vector<int> free_columns;
+	vector<bool> is_pivot(n, false);
+	for (int c : pivot_column) {
+		is_pivot[c] = true;
+	}
+	for (int c = 0; c < n; c++) {
+		if (fixed[c] < 0 && !is_pivot[c]) free_columns.push_back(c);
+	}
+	if (free_columns.size() > MAX_SIZE) {
+		if (verbose) *log_output << free_columns.size() << " free squares after reduction, too many to search" << endl;
+		return -1;
+	}
+	if (verbose) *log_output << "Edge of " << n << " squares reduced to " << free_columns.size() << " free squares" << endl;
+
+	//Enumerate free squares, solving for each pivot square
+	vector<double> counts(n, 0);
+	edge_histogram.assign(n + 1, 0);
+	double count_possibilities = 0;
+	double mine_count = 0;
+	vector<int> values(n, 0);
+	for (long long possibility = 0; consistent && possibility < (1LL << free_columns.size()); possibility++) {
+		if ((possibility & 1023) == 1023 && past_deadline()) {
+			if (verbose) *log_output << "Edge search out of time after " << possibility << " possibilities" << endl;
+			return -1;
+		}
+		for (int f = 0; f < free_columns.size(); f++) {
+			values[free_columns[f]] = (possibility >> f) & 1;
+		}
+		bool valid = true;
+		for (int k = 0; k < pivot_column.size() && valid; k++) {
+			int c = pivot_column[k];
+			long long rhs = rows[k][n];
+			for (int f : free_columns) {
+				rhs -= rows[k][f] * values[f];
+			}
+			if (rhs != 0 && rhs != rows[k][c]) {
+				valid = false;
+			}
+			values[c] = rhs == 0 ? 0 : 1;
+		}
+		for (int k = pivot_column.size(); k < rows.size() && valid; k++) { //Remaining rows have no squares left
+			valid = rows[k][n] == 0;
+		}
+		if (!valid) continue;
+		int mines = 0;
+		for (int c = 0; c < n; c++) {
+			int v = fixed[c] >= 0 ? fixed[c] : values[c];
+			counts[c] += v;
+			mines += v;
+		}
+		edge_histogram[mines]++;
+		count_possibilities++;
+		mine_count += mines;
+	}
+	if (verbose) *log_output << count_possibilities << " possibilities found for edge" << endl;
+
+	for (int i = 0; i < n; i++) {
+		pair<int, int> p = (*edge)[i];
+		m_probabilities[p.first][p.second] = counts[i] / count_possibilities;
+		if (verbose) *log_output << p.first << "," << p.second << ": " << m_probabilities[p.first][p.second] << endl;
+	}
+
+	return mine_count / count_possibilities;
+}
+
+//Precise search counting possibilities with the model counter, which splits the edge into independent components as squares are assigned
+//Returns -1 if out of time or if the components stay too large to count
+double Bot::update_probabilities_counted(vector<pair<int, int>>* edge) {
+	EdgeLayout layout; //Get constraints
+	build_layout(edge, edge->size(), &layout);
+	vector<CountConstraint> constraints(layout.remaining.size());
+	for (int c = 0; c < constraints.size(); c++) {
+		constraints[c].squares.assign(layout.constraint_squares.begin() + layout.constraint_start[c], layout.constraint_squares.begin() + layout.constraint_start[c + 1]);
+		constraints[c].remaining = layout.remaining[c];
+	}
+
+	vector<double> counts;
+	model_counter.set_deadline(edge_deadline, time_budget > 0);
+	if (!model_counter.count(edge->size(), &constraints, &counts, &edge_histogram)) {
+		if (verbose) *log_output << "Model counting stopped after " << model_counter.get_nodes() << " branches" << endl;
+		return -1;
+	}
+	double count_possibilities = 0;
+	double mine_count = 0;
+	for (int k = 0; k < edge_histogram.size(); k++) {
+		count_possibilities += edge_histogram[k];
+		mine_count += k * edge_histogram[k];
+	}
+	if (verbose) *log_output << count_possibilities << " possibilities counted for edge in " << model_counter.get_nodes() << " branches (" << model_counter.get_cache_hits() << " cached, up to " << model_counter.get_max_components() << " components)" << endl;
+
+	for (int i = 0; i < edge->size(); i++) {
+		pair<int, int> p = (*edge)[i];
+		m_probabilities[p.first][p.second] = counts[i] / count_possibilities;
+		if (verbose) *log_output << p.first << "," << p.second << ": " << m_probabilities[p.first][p.second] << endl;
+	}
+
+	return mine_count / count_possibilities;
+}
+
+//Precise search, reusing results for edges with the same structure from the shared pattern cache
+double Bot::update_probabilities_cached(vector<pair<int, int>>* edge) {
+	if (solution_cache == nullptr) {
+		return update_probabilities_precise(edge);
+	}
+
+	unordered_map<pair<int, int>, int, PairHashStruct> adjacent_counts; //Get constraints with remaining counts
+	for (int i = 0; i < edge->size(); i++) {
+		pair<int, int> p = (*edge)[i];
+		execute_callback(board, p.first, p.second, &insert_into_map, &adjacent_counts);
+	}
+	vector<pair<pair<int, int>, int>> constraints;
+	for (pair<pair<int, int>, int> p : adjacent_counts) {
+		int flag_count = 0;
+		execute_callback(board, p.first.first, p.first.second, &count_known_mines, &flag_count);
+		constraints.push_back(make_pair(p.first, p.second - flag_count));
+	}
+	vector<int> order;
+	string key = SolutionCache::canonical_key(*edge, constraints, &order);
+
+	CachedPattern pattern;
+	if (solution_cache->lookup(key, &pattern)) {
+		double count_possibilities = 0;
+		double mine_count = 0;
+		for (int k = 0; k < pattern.histogram.size(); k++) {
+			count_possibilities += pattern.histogram[k];
+			mine_count += k * pattern.histogram[k];
+		}
+		for (int k = 0; k < order.size(); k++) {
+			pair<int, int> p = (*edge)[order[k]];
+			m_probabilities[p.first][p.second] = pattern.square_counts[k] / count_possibilities;
+		}
+		edge_histogram = pattern.histogram;
+		if (verbose) *log_output << count_possibilities << " possibilities found for edge in pattern cache" << endl;
+		return mine_count / count_possibilities;
+	}
+
+	double mine_count = update_probabilities_precise(edge);
+	double count_possibilities = 0;
+	for (double h : edge_histogram) {
+		count_possibilities += h;
+	}
+	if (mine_count >= 0 && count_possibilities > 0) { //Store counts rather than probabilities to keep results exact
+		pattern.histogram = edge_histogram;
+		for (int k = 0; k < order.size(); k++) {
+			pair<int, int> p = (*edge)[order[k]];
+			pattern.square_counts.push_back(round(m_probabilities[p.first][p.second] * count_possibilities));
+		}
+		solution_cache->insert(key, pattern);
+	}
+	return mine_count;
+}
+
+//Brute force algorithm for calculating edge probabilities
+//Guaranteed optimal results, but runs in exponential time and struggles with large enough edges
+double Bot::update_probabilities_precise(vector<pair<int, int>>* edge) { //Precisely calculates probabilities for small edges
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	int* good_count = new int[NUM_THREADS * edge->size()];
+	int success_count[NUM_THREADS] = { 0 };
+	int flag_count = 0;
+	double mine_count = 0;
+
+	unordered_map<pair<int, int>, int, PairHashStruct> adjacent_counts; //For each edge square, store number of adjacent squares (known squares) bordering the edge 
+	for (int i = 0; i < edge->size(); i++) {
+		pair<int, int> p = (*edge)[i];
+		execute_callback(board, p.first, p.second, &insert_into_map, &adjacent_counts);
+	}
+
+	for (pair<pair<int, int>, int> p : adjacent_counts) { //For each adjacent square, count the number of mines in the edge
+		flag_count = 0;
+		execute_callback(board, p.first.first, p.first.second, &count_known_mines, &flag_count);
+		adjacent_counts[p.first] -= flag_count;
+	}
+
+	int count_possibilities = 0;
+	edge_histogram.assign(edge->size() + 1, 0);
+
+	for (int i = 0; i < edge->size(); i++) { //Reset probabilities of edge squares
+		pair<int, int> p = (*edge)[i];
+		m_probabilities[p.first][p.second] = 0;
+	}
+
+	for (int i = 0; i < (int)pow(2, edge->size()); i++) { //Check each possibility (exponential time)
+		if ((i & 1023) == 0 && past_deadline()) { //Out of time, results are incomplete
+			delete[] good_count;
+			return -1;
+		}
+		unordered_map<pair<int, int>, int, PairHashStruct> possibility_counts;
+		for (pair<pair<int, int>, int> p : adjacent_counts) { //Deep copy of adjacent_count
+			possibility_counts[p.first] = p.second;
+		}
+
+		for (int j = 0; j < edge->size(); j++) { //Subtract counts if the current possibility has edge square as flag
+			if (((i >> j) & 1) == 1) {
+				execute_callback(board, (*edge)[j].first, (*edge)[j].second, &decrement_count, &possibility_counts);
+			}
+		}
+
+		bool good_possibility = true;
+		for (pair<pair<int, int>, int> p : possibility_counts) { //Check each count
+			if (p.second != 0) {
+				good_possibility = false;
+			}
+		}
+
+		if (good_possibility) { //Good possibility
+			count_possibilities += 1;
+			int possibility_mines = 0;
+			for (int j = 0; j < edge->size(); j++) { //Increment probability for flag squares on this possibility
+				if (((i >> j) & 1) == 1) {
+					pair<int, int> p = (*edge)[j];
+					m_probabilities[p.first][p.second] += 1;
+					possibility_mines += 1;
+				}
+			}
+			mine_count += possibility_mines;
+			edge_histogram[possibility_mines] += 1;
+		}
+	}
+
+	if (verbose) *log_output << count_possibilities << " possibilities found for edge" << endl;
+	if (cost_model != nullptr) { //Only complete searches are recorded, as a search out of time gives no measure of its full cost
+		cost_model->record(edge->size(), adjacent_counts.size(), chrono::duration<double, milli>(chrono::steady_clock::now() - start).count());
+	}
+
+	for (int i = 0; i < edge->size(); i++) { //Adjust probabilities for number of possibilities
+		pair<int, int> p = (*edge)[i];
+		m_probabilities[p.first][p.second] /= count_possibilities;
+		if (verbose) *log_output << p.first << "," << p.second << ": " << m_probabilities[p.first][p.second] << endl;
+	}
+
+	delete[] good_count;
+
+	return mine_count / count_possibilities;
+}
+
+//Approximation of optimal edge probabilities by splitting constraints for each edge into a subset of constraints
+//Find possibilities for edge squares constrained by each subset
+//Struggles with intersection of multiple subsets (for edges squares relevant to more than one subset)
+double Bot::update_probabilities_sectioned(vector<pair<int, int>>* edge) {
+	int* good_count = new int[NUM_THREADS * edge->size()];
+	int success_count[NUM_THREADS] = { 0 };
+	int flag_count = 0;
+
+	unordered_map<pair<int, int>, int, PairHashStruct> adjacent_counts; //Get constraints
+	for (int i = 0; i < edge->size(); i++) {
+		pair<int, int> p = (*edge)[i];
+		execute_callback(board, p.first, p.second, &insert_into_map, &adjacent_counts);
+
+	}
+	for (pair<pair<int, int>, int> p : adjacent_counts) { //Adjust constraints for existing flags
+		flag_count = 0;
+		execute_callback(board, p.first.first, p.first.second, &count_known_mines, &flag_count);
+		adjacent_counts[p.first] -= flag_count;
+	}
+
+	for (int i = 0; i < edge->size(); i++) { //Zero out probabilities of existing edge squares
+		pair<int, int> p = (*edge)[i];
+		m_probabilities[p.first][p.second] = 0;
+	}
+
+	double mine_count = 0;
+	for (pair<pair<int, int>, int> p : adjacent_counts) { //Approximate mine count of edge
+		mine_count += p.second;
+	}
+
+	//Generate edge subsets
+	unordered_set<pair<int, int>, PairHashStruct>* s_map = new unordered_set <pair<int, int>, PairHashStruct>[adjacent_counts.size()];
+	unordered_set<pair<int, int>, PairHashStruct>* i_map = new unordered_set <pair<int, int>, PairHashStruct>[adjacent_counts.size()];
+	unordered_map<pair<int, int>, unordered_set<pair<int, int>, PairHashStruct>*, PairHashStruct> interior_to_edge_squares_map;
+	unordered_map<pair<int, int>, unordered_set<pair<int, int>, PairHashStruct>*, PairHashStruct> interior_to_interior_squares_map;
+	int ind = 0;
+	for (pair<pair<int, int>, int> p : adjacent_counts) { //Get map of constraints to edge squares
+		execute_callback(board, p.first.first, p.first.second, &build_adjacency_set, &s_map[ind]);
+		interior_to_edge_squares_map[p.first] = &s_map[ind];
+		ind += 1;
+	}
+
+	ind = 0;
+	for (pair<pair<int, int>, int> p : adjacent_counts) { //Get map of interior squares to adjacent interior squares
+		for (pair<int, int> c : *interior_to_edge_squares_map[p.first]) {
+			for (pair<pair<int, int>, int> comp : adjacent_counts) {
+				if (interior_to_edge_squares_map[comp.first]->find(c) != interior_to_edge_squares_map[comp.first]->end() && comp.first != p.first) {
+					i_map[ind].insert(comp.first);
+				}
+			}
+		}
+		interior_to_interior_squares_map[p.first] = &i_map[ind];
+		ind += 1;
+	}
+
+	pair<int, int>* adjacent_ordered = new pair<int, int>[adjacent_counts.size()];
+	ind = 0;
+	for (pair<pair<int, int>, int> p : adjacent_counts) { //Order the unordered map
+		adjacent_ordered[ind] = p.first;
+		ind += 1;
+	}
+
+	//Tree search for subsets satisfying edges size constraint
+	//The subtree of each root constraint is independent, so each is built, read for its leaves and freed as its own task
+	vector<vector<unordered_set<pair<int, int>, PairHashStruct>>> root_leaves(adjacent_counts.size()); //Distinct subsets of each root, in the order they are found
+	vector<vector<vector<int>>> root_signatures(adjacent_counts.size());
+	vector<char> root_finished(adjacent_counts.size(), 0);
+	vector<char> root_fallback(adjacent_counts.size(), 0);
+	long long tree_memory_budget = sectioned_memory_budget / (task_pool == nullptr ? 1 : task_pool->get_threads()); //Shared by the trees built at once
+	run_tasks(adjacent_counts.size(), [&](int r) {
+		vector<AdjacencyOrderingNode*> adjacency_build_queue;
+		vector<AdjacencyOrderingNode*> roots;
+		set<vector<int>> expanded; //States of the nodes expanded so far
+		long long tree_bytes = 0;
+		int tree_nodes = 1;
+		AdjacencyOrderingNode* root = new AdjacencyOrderingNode; //Initialize root node for the constraint
+		root->coord = adjacent_ordered[r];
+		root->parent = nullptr;
+		root->duplicate = false;
+		adjacency_build_queue.push_back(root);
+		roots.push_back(root);
+		tree_bytes += adjacency_node_bytes(root);
+		track_memory(adjacency_node_bytes(root));
+
+		while (!adjacency_build_queue.empty()) { //Depth first search through the nodes of the tree
+			if (past_deadline()) { //Out of time, nodes still in the queue are attached to the tree and freed with it
+				free_adjacency_tree(&roots);
+				track_memory(-tree_bytes);
+				return;
+			}
+			if ((sectioned_node_budget > 0 && tree_nodes > sectioned_node_budget) || (tree_memory_budget > 0 && tree_bytes > tree_memory_budget)) {
+				root_fallback[r] = 1;
+				break;
+			}
+			AdjacencyOrderingNode* node = adjacency_build_queue.back();
+			adjacency_build_queue.pop_back();
+			long long node_bytes = adjacency_node_bytes(node);
+			for (pair<int, int> p : *interior_to_edge_squares_map[node->coord]) { //Add all adjacent edge squares to the edge square set
+				if (node->current_squares.find(p) == node->current_squares.end()) {
+					node->current_squares.insert(p);
+				}
+			}
+			if (node->current_squares.size() > MAX_SIZE) { //Exceeded number of maximum possible edge square, remove node from tree
+				if (node->parent != nullptr) {
+					node->parent->children.erase(find(node->parent->children.begin(), node->parent->children.end(), node));
+				}
+				else { //Root alone is too large, no subsets start from it
+					roots.clear();
+				}
+				tree_bytes -= node_bytes;
+				track_memory(-node_bytes);
+				delete node;
+			}
+			else {
+				vector<int> state; //Sorted constraints of the path, then the last constraint, which decide the node's subtree
+				for (pair<int, int> v : node->visited) {
+					state.push_back(v.first * m_cols + v.second);
+				}
+				state.push_back(node->coord.first * m_cols + node->coord.second);
+				sort(state.begin(), state.end());
+				state.push_back(node->coord.first * m_cols + node->coord.second);
+				if (!expanded.insert(state).second) { //Subtree already built through another path, its leaves would all be duplicates
+					node->duplicate = true;
+					continue;
+				}
+				long long state_bytes = sizeof(vector<int>) + state.size() * sizeof(int) + 4 * sizeof(void*);
+				for (pair<int, int> p : *interior_to_interior_squares_map[node->coord]) { //Good number of squares, add children to tree
+					if (node->visited.find(p) == node->visited.end()) {
+						int added = 0; //Children that would exceed the maximum edge size are never created
+						for (pair<int, int> c : *interior_to_edge_squares_map[p]) {
+							added += node->current_squares.find(c) == node->current_squares.end();
+						}
+						if (node->current_squares.size() + added > MAX_SIZE) {
+							continue;
+						}
+						AdjacencyOrderingNode *n = new AdjacencyOrderingNode;
+						n->parent = node;
+						for (pair<int, int> v : node->visited) { //Copy visited set
+							n->visited.insert(v);
+						}
+						n->visited.insert(node->coord);
+						for (pair<int, int> c : node->current_squares) { //Copy current square set
+							n->current_squares.insert(c);
+						}
+						n->coord = p;
+						n->duplicate = false;
+						node->children.push_back(n);
+						adjacency_build_queue.push_back(n); //Push to stack
+						state_bytes += adjacency_node_bytes(n);
+						tree_nodes += 1;
+					}
+				}
+				state_bytes += adjacency_node_bytes(node) - node_bytes;
+				tree_bytes += state_bytes;
+				track_memory(state_bytes);
+			}
+		}
+
+		if (root_fallback[r]) { //Budget reached, grow one subset from the root instead, adding adjacent constraints while the sub-edge stays small enough
+			free_adjacency_tree(&roots);
+			track_memory(-tree_bytes);
+			unordered_set<pair<int, int>, PairHashStruct> subset;
+			unordered_set<pair<int, int>, PairHashStruct> squares;
+			unordered_set<pair<int, int>, PairHashStruct> seen;
+			vector<pair<int, int>> candidates(1, adjacent_ordered[r]);
+			seen.insert(adjacent_ordered[r]);
+			for (int k = 0; k < candidates.size(); k++) {
+				int added = 0;
+				for (pair<int, int> p : *interior_to_edge_squares_map[candidates[k]]) {
+					added += squares.find(p) == squares.end();
+				}
+				if (squares.size() + added > MAX_SIZE) {
+					if (k == 0) { //Root alone is too large
+						break;
+					}
+					continue;
+				}
+				subset.insert(candidates[k]);
+				for (pair<int, int> p : *interior_to_edge_squares_map[candidates[k]]) {
+					squares.insert(p);
+				}
+				for (pair<int, int> p : *interior_to_interior_squares_map[candidates[k]]) {
+					if (seen.insert(p).second) {
+						candidates.push_back(p);
+					}
+				}
+			}
+			if (!subset.empty()) {
+				vector<int> signature;
+				for (pair<int, int> p : subset) {
+					signature.push_back(p.first * m_cols + p.second);
+				}
+				sort(signature.begin(), signature.end());
+				root_leaves[r].push_back(subset);
+				root_signatures[r].push_back(signature);
+			}
+			root_finished[r] = 1;
+			return;
+		}
+
+		//Traverse tree to get the constraint subset of each leaf
+		set<vector<int>> existing_traversals;
+		adjacency_build_queue = roots;
+		while (!adjacency_build_queue.empty()) {
+			AdjacencyOrderingNode* node = adjacency_build_queue.back();
+			adjacency_build_queue.pop_back();
+			if (node->duplicate) {
+				continue;
+			}
+			if (node->children.size() == 0) { //Leaf node, add to list unless the root already has the same subset
+				node->visited.insert(node->coord);
+				vector<int> signature; //Sorted flat ids of the subset's constraints
+				for (pair<int, int> p : node->visited) {
+					signature.push_back(p.first * m_cols + p.second);
+				}
+				sort(signature.begin(), signature.end());
+				if (existing_traversals.insert(signature).second) {
+					root_leaves[r].push_back(node->visited);
+					root_signatures[r].push_back(signature);
+				}
+			}
+			else {
+				for (AdjacencyOrderingNode* n : node->children) {
+					adjacency_build_queue.push_back(n); //Search children for non-leaf node
+				}
+			}
+		}
+		free_adjacency_tree(&roots);
+		track_memory(-tree_bytes);
+		root_finished[r] = 1;
+	});
+
+	bool out_of_time = false;
+	for (int r = 0; r < adjacent_counts.size() && !out_of_time; r++) {
+		out_of_time = !root_finished[r];
+	}
+	if (out_of_time) {
+		delete[] s_map;
+		delete[] i_map;
+		delete[] good_count;
+		delete[] adjacent_ordered;
+		return -1;
+	}
+	if (verbose) {
+		int fallbacks = count(root_fallback.begin(), root_fallback.end(), 1);
+		if (fallbacks > 0) *log_output << fallbacks << " sub-edge trees reached the node or memory budget, using greedy subsets for their roots" << endl;
+		*log_output << "Sub-edge trees used up to " << search_memory->peak / 1024 << " KB this move" << endl;
+	}
+
+	//Merge the subsets of each root, last root first, keeping the first subset with each signature
+	set<vector<int>> existing_traversals;
+	vector<unordered_set<pair<int,int>, PairHashStruct>> adjacent_subsets;
+	for (int r = adjacent_counts.size() - 1; r >= 0; r--) {
+		for (int k = 0; k < root_leaves[r].size(); k++) {
+			if (existing_traversals.insert(root_signatures[r][k]).second) { //Check for duplicate set
+				adjacent_subsets.push_back(move(root_leaves[r][k]));
+			}
+		}
+	}
+
+	//Remove subsets
+	for (vector<unordered_set<pair<int, int>, PairHashStruct>>::iterator itr = adjacent_subsets.begin(); itr != adjacent_subsets.end(); itr++) {
+		for (vector<unordered_set<pair<int, int>, PairHashStruct>>::iterator del = itr + 1; del != adjacent_subsets.end(); del++) {
+			if (is_subset(*itr, *del)) {
+				del = adjacent_subsets.erase(del);
+				del--;
+			}
+		}
+	}
+
+	if (verbose) *log_output << adjacent_subsets.size() << " unique subsets found" << endl;
+
+	//Get edge squares from each constraint subset
+	vector <unordered_set<pair<int, int>, PairHashStruct>*> sub_edges;
+	for (unordered_set<pair<int, int>, PairHashStruct> s : adjacent_subsets) {
+		unordered_set < pair<int, int>, PairHashStruct>* set = new unordered_set < pair<int, int>, PairHashStruct>;
+		for (pair<int, int> p : s) {
+			for (pair<int, int> l : *interior_to_edge_squares_map[p]) {
+				set->insert(l);
+			}
+		}
+		sub_edges.push_back(set);
+	}
+
+	unordered_map<pair<int, int>, int, PairHashStruct> correction; //Initialize storage of count of number of subsets an edge square appears in
+	for (pair<pair<int, int>, int> p : adjacent_counts) {
+		correction[p.first] = 0;
+	}
+
+	unordered_set<pair<int, int>, PairHashStruct> subset_union; //Union of all edge squares for subsets
+	for (unordered_set<pair<int, int>, PairHashStruct>* se: sub_edges) {
+		for (pair<int, int> p : *se) {
+			subset_union.insert(p);
+		}
+	}
+	for (vector<pair<int, int>>::iterator itr = edge->begin(); itr != edge->end(); ) { //Remove all edge squares not in subsets from edge (to prevent later changes to probability)
+		if (subset_union.find(*itr) == subset_union.end()) {
+			itr = edge->erase(itr);
+		}
+		else {
+			itr++;
+		}
+	}
+	
+	//Brute force check possibilities for each subset, as independent tasks counting into their own buffers
+	vector<vector<pair<int, int>>> subset_squares(sub_edges.size());
+	for (int k = 0; k < sub_edges.size(); k++) { //Get sub-edge for each subset
+		for (pair<int, int> p : *sub_edges[k]) {
+			subset_squares[k].push_back(p);
+		}
+	}
+	vector<vector<int>> subset_mines(sub_edges.size()); //Number of good possibilities with each sub-edge square as a mine
+	vector<int> subset_possibilities(sub_edges.size(), 0);
+	vector<char> subset_finished(sub_edges.size(), 0);
+	run_tasks(sub_edges.size(), [&](int k) {
+		vector<pair<int, int>>& e = subset_squares[k];
+		unordered_set<pair<int, int>, PairHashStruct>& interior = adjacent_subsets[k];
+		vector<int>& mines = subset_mines[k];
+		mines.assign(e.size(), 0);
+		vector<pair<int, int>> constraints(interior.begin(), interior.end()); //Only the subset's constraints are checked
+		vector<int> need;
+		for (pair<int, int> c : constraints) {
+			need.push_back(adjacent_counts.at(c));
+		}
+		vector<vector<int>> square_constraints(e.size()); //Constraints of the subset adjacent to each sub-edge square
+		for (int j = 0; j < e.size(); j++) {
+			for (int c = 0; c < constraints.size(); c++) {
+				if (abs(constraints[c].first - e[j].first) <= 1 && abs(constraints[c].second - e[j].second) <= 1) {
+					square_constraints[j].push_back(c);
+				}
+			}
+		}
+		vector<int> possibility_counts(constraints.size());
+		for (int i = 0; i < (int)pow(2, e.size()); i++) { //Check each possibility (exponential time)
+			if ((i & 1023) == 0 && past_deadline()) {
+				return;
+			}
+			possibility_counts = need;
+			for (int j = 0; j < e.size(); j++) { //Subtract counts if the current possibility has edge square as flag
+				if (((i >> j) & 1) == 1) {
+					for (int c : square_constraints[j]) {
+						possibility_counts[c] -= 1;
+					}
+				}
+			}
+
+			bool good_possibility = true;
+			for (int c = 0; c < constraints.size() && good_possibility; c++) { //Check each count
+				good_possibility = possibility_counts[c] == 0;
+			}
+
+			if (good_possibility) { //Good possibility
+				subset_possibilities[k] += 1;
+				for (int j = 0; j < e.size(); j++) { //Count flag squares on this possibility
+					if (((i >> j) & 1) == 1) {
+						mines[j] += 1;
+					}
+				}
+			}
+		}
+		subset_finished[k] = 1;
+	});
+
+	//Merge subsets in order, each averaging its squares with the subsets before it
+	for (int k = 0; k < sub_edges.size() && !out_of_time; k++) {
+		if (!subset_finished[k]) {
+			out_of_time = true;
+			break;
+		}
+		if (verbose) *log_output << subset_possibilities[k] << " possibilities found for subset" << endl;
+		for (int j = 0; j < subset_squares[k].size(); j++) { //Adjust probabilities
+			pair<int, int> p = subset_squares[k][j];
+			correction[p] += 1;
+			m_probabilities[p.first][p.second] = (m_probabilities[p.first][p.second] + subset_mines[k][j]) / subset_possibilities[k];
+		}
+	}
+	for (int j = 0; j < edge->size() && !out_of_time; j++){ //Adjust probabilities for frequency
+		pair<int, int> p = (*edge)[j];
+		if (correction[p] != 0) {
+			m_probabilities[p.first][p.second] /= correction[p];
+		}
+		if (verbose) *log_output << p.first << ", " << p.second << ":  " << m_probabilities[p.first][p.second] << endl;
+	}
+
+	//Cleanup
+	delete[] s_map;
+	delete[] i_map;
+	delete[] good_count;
+	delete[] adjacent_ordered;
+
+	for (int i = 0; i < sub_edges.size(); i++) {
+		delete sub_edges[i];
+	}
+
+	if (out_of_time) {
+		return -1;
+	}
+	return mine_count / edge->size();
+}
+
+//Linear time estimate of edge probabilities from each constraint on its own
+//A square is safe (or a mine) if any adjacent constraint guarantees it, otherwise the mean of its constraints' mine densities
+//Used when the time budget runs out before any search of the edge completes
+double Bot::update_probabilities_estimate(vector<pair<int, int>>* edge) {
+	int flag_count = 0;
+	int open_spaces = 0;
+
+	unordered_map<pair<int, int>, int, PairHashStruct> adjacent_counts; //Get constraints
+	for (int i = 0; i < edge->size(); i++) {
+		pair<int, int> p = (*edge)[i];
+		execute_callback(board, p.first, p.second, &insert_into_map, &adjacent_counts);
+	}
+
+	unordered_map<pair<int, int>, double, PairHashStruct> density; //Remaining mines per unknown square for each constraint
+	for (pair<pair<int, int>, int> p : adjacent_counts) {
+		flag_count = 0;
+		open_spaces = 0;
+		execute_callback(board, p.first.first, p.first.second, &count_known_mines, &flag_count);
+		execute_callback(board, p.first.first, p.first.second, &count_unknown_spaces, &open_spaces);
+		density[p.first] = (double)(p.second - flag_count) / open_spaces;
+	}
+
+	double mine_count = 0;
+	for (int i = 0; i < edge->size(); i++) {
+		pair<int, int> p = (*edge)[i];
+		unordered_map<pair<int, int>, int, PairHashStruct> constraints;
+		execute_callback(board, p.first, p.second, &insert_into_map, &constraints);
+
+		double total = 0;
+		bool safe = false;
+		bool mine = false;
+		for (pair<pair<int, int>, int> c : constraints) {
+			total += density[c.first];
+			safe = safe || density[c.first] <= 0.0;
+			mine = mine || density[c.first] >= 1.0;
+		}
+		if (safe) {
+			m_probabilities[p.first][p.second] = 0.0;
+		}
+		else if (mine) {
+			m_probabilities[p.first][p.second] = 1.0;
+		}
+		else {
+			m_probabilities[p.first][p.second] = total / constraints.size();
+		}
+		mine_count += m_probabilities[p.first][p.second];
+		if (verbose) *log_output << p.first << ", " << p.second << ":  " << m_probabilities[p.first][p.second] << endl;
+	}
+
+	return mine_count;
+}
+
+//Markov chain Monte Carlo estimate of edge probabilities for edges too large to search precisely
+//Starts from a random valid possibility found by backtracking, then proposes flipping one square, or two or three squares sharing constraints
+//Proposals keeping every constraint satisfied are accepted with the ratio of their weights under the global mine count,
+//treating all unknown squares outside the edge as unconstrained
+//Draws the sample budget of proposals (or until the edge deadline), with confidence intervals from batch means
+double Bot::update_probabilities_sampled(vector<pair<int, int>>* edge) {
+	if (defer_sampling) { //Sampled by the owner instead, in edge order
+		sampling_deferred = true;
+		return 0;
+	}
+	const int NUM_BATCHES = 20;
+	int n = edge->size();
+	int flag_count = 0;
+
+	unordered_map<pair<int, int>, int, PairHashStruct> adjacent_counts; //Get constraints
+	for (int i = 0; i < n; i++) {
+		pair<int, int> p = (*edge)[i];
+		execute_callback(board, p.first, p.second, &insert_into_map, &adjacent_counts);
+	}
+
+	//Index constraints and squares
+	unordered_map<pair<int, int>, int, PairHashStruct> square_index;
+	for (int i = 0; i < n; i++) {
+		square_index[(*edge)[i]] = i;
+	}
+	vector<int> need; //Remaining mines for each constraint
+	vector<vector<int>> square_constraints(n);
+	for (pair<pair<int, int>, int> p : adjacent_counts) {
+		flag_count = 0;
+		execute_callback(board, p.first.first, p.first.second, &count_known_mines, &flag_count);
+		vector<pair<int, int>> unknown;
+		execute_callback(board, p.first.first, p.first.second, &append_to_vector, &unknown);
+		for (pair<int, int> u : unknown) {
+			square_constraints[square_index[u]].push_back(need.size());
+		}
+		need.push_back(p.second - flag_count);
+	}
+	vector<vector<int>> constraint_squares(need.size());
+	for (int i = 0; i < n; i++) {
+		for (int c : square_constraints[i]) {
+			constraint_squares[c].push_back(i);
+		}
+	}
+	vector<vector<int>> square_neighbours(n); //Squares sharing a constraint
+	for (int i = 0; i < n; i++) {
+		unordered_set<int> seen;
+		for (int c : square_constraints[i]) {
+			for (int j : constraint_squares[c]) {
+				if (j != i && seen.insert(j).second) {
+					square_neighbours[i].push_back(j);
+				}
+			}
+		}
+	}
+
+	//Weight of a possibility with k edge mines: ways to place the remaining mines outside the edge
+	int count_known = 0;
+	int count_tot = 0;
+	for (int i = 0; i < m_rows; i++) {
+		for (int j = 0; j < m_cols; j++) {
+			if (board->is_marked_mine(i, j)) {
+				count_known += 1;
+			}
+			else if (!board->is_known(i, j)) {
+				count_tot += 1;
+			}
+		}
+	}
+	int outside = count_tot - n;
+	int remaining = m_mines - count_known;
+	vector<double> log_weight(n + 1);
+	for (int k = 0; k <= n; k++) {
+		if (remaining - k < 0 || remaining - k > outside) {
+			log_weight[k] = -INFINITY;
+		}
+		else {
+			log_weight[k] = lgamma(outside + 1) - lgamma(remaining - k + 1) - lgamma(outside - remaining + k + 1);
+		}
+	}
+
+	//Backtracking for a random starting possibility
+	vector<int> have(need.size(), 0); //Mines placed for each constraint
+	vector<int> open(need.size(), 0); //Unassigned squares for each constraint
+	for (int c = 0; c < need.size(); c++) {
+		open[c] = constraint_squares[c].size();
+	}
+	vector<char> state(n, 0);
+	vector<char> tried(n, 0); //Number of values tried for each square
+	vector<char> first(n, 0); //First value tried for each square
+	int depth = 0;
+	long long steps = 0;
+	while (depth >= 0 && depth < n) {
+		if ((++steps & 1023) == 0 && past_deadline()) {
+			return -1;
+		}
+		if (tried[depth] == 2) { //Both values failed, backtrack
+			tried[depth] = 0;
+			depth -= 1;
+			if (depth >= 0) {
+				for (int c : square_constraints[depth]) { //Unassign previous square
+					have[c] -= state[depth];
+					open[c] += 1;
+				}
+			}
+			continue;
+		}
+		if (tried[depth] == 0) {
+			first[depth] = m_rng() & 1;
+		}
+		char value = tried[depth] == 0 ? first[depth] : 1 - first[depth];
+		tried[depth] += 1;
+		bool valid = true;
+		for (int c : square_constraints[depth]) { //Check that constraint can still be satisfied
+			if (have[c] + value > need[c] || have[c] + value + open[c] - 1 < need[c]) {
+				valid = false;
+			}
+		}
+		if (valid) {
+			state[depth] = value;
+			for (int c : square_constraints[depth]) {
+				have[c] += value;
+				open[c] -= 1;
+			}
+			depth += 1;
+		}
+	}
+	if (depth < 0) { //No valid possibility (inconsistent flags)
+		return -1;
+	}
+
+	//Metropolis sampling
+	int k = 0;
+	for (int i = 0; i < n; i++) {
+		k += state[i];
+	}
+	long long burn_in = sample_budget / 10;
+	long long batch_size = max(1, sample_budget / NUM_BATCHES);
+	vector<long long> mine_time(n, 0); //Number of samples each square spent as a mine
+	vector<long long> last_change(n, 0);
+	vector<double> batch_sum(n, 0);
+	vector<double> batch_sq_sum(n, 0);
+	vector<long long> batch_start(n, 0);
+	double k_sum = 0;
+	int batches = 0;
+	long long t = 0;
+	vector<int> flip;
+	uniform_int_distribution<int> pick_square(0, n - 1);
+	for (long long step = 0; step < burn_in + batch_size * NUM_BATCHES; step++) {
+		if ((step & 1023) == 0 && past_deadline()) {
+			break;
+		}
+
+		//Propose flipping a connected group of one to three squares
+		flip.clear();
+		flip.push_back(pick_square(m_rng));
+		int group = m_rng() % 3;
+		for (int g = 0; g < group && !square_neighbours[flip.back()].empty(); g++) {
+			vector<int>& neighbours = square_neighbours[flip.back()];
+			int next = neighbours[m_rng() % neighbours.size()];
+			if (find(flip.begin(), flip.end(), next) == flip.end()) {
+				flip.push_back(next);
+			}
+		}
+		int new_k = k;
+		for (int i : flip) {
+			new_k += state[i] ? -1 : 1;
+			for (int c : square_constraints[i]) {
+				have[c] += state[i] ? -1 : 1;
+			}
+		}
+		bool valid = true;
+		for (int i : flip) {
+			for (int c : square_constraints[i]) {
+				if (have[c] != need[c]) {
+					valid = false;
+				}
+			}
+		}
+		if (valid && log_weight[new_k] < log_weight[k]) { //Metropolis acceptance for global mine count
+			valid = uniform_real_distribution<double>(0, 1)(m_rng) < exp(log_weight[new_k] - log_weight[k]);
+		}
+
+		if (valid) {
+			for (int i : flip) {
+				if (state[i] && step >= burn_in) {
+					mine_time[i] += step - max(last_change[i], burn_in);
+				}
+				last_change[i] = step;
+				state[i] = 1 - state[i];
+			}
+			k = new_k;
+		}
+		else {
+			for (int i : flip) { //Undo
+				for (int c : square_constraints[i]) {
+					have[c] += state[i] ? 1 : -1;
+				}
+			}
+		}
+
+		if (step >= burn_in) {
+			k_sum += k;
+			t += 1;
+			if (t % batch_size == 0) { //End of batch, record batch mean for each square
+				for (int i = 0; i < n; i++) {
+					if (state[i]) {
+						mine_time[i] += step + 1 - max(last_change[i], burn_in);
+						last_change[i] = step + 1;
+					}
+					double mean = (double)(mine_time[i] - batch_start[i]) / batch_size;
+					batch_sum[i] += mean;
+					batch_sq_sum[i] += mean * mean;
+					batch_start[i] = mine_time[i];
+				}
+				batches += 1;
+			}
+		}
+	}
+	if (batches < 2) { //Not enough samples before the deadline
+		return -1;
+	}
+
+	for (int i = 0; i < n; i++) { //Sampled squares are never certain, clamp away from 0 and 1
+		pair<int, int> p = (*edge)[i];
+		double mean = batch_sum[i] / batches;
+		double variance = max(0.0, (batch_sq_sum[i] - batches * mean * mean) / (batches - 1));
+		double bound = 0.5 / (batch_size * batches);
+		m_probabilities[p.first][p.second] = min(max(mean, bound), 1 - bound);
+		m_confidence[p] = 1.96 * sqrt(variance / batches);
+		if (verbose) *log_output << p.first << ", " << p.second << ":  " << m_probabilities[p.first][p.second] << " +/- " << m_confidence[p] << endl;
+	}
+	if (verbose) *log_output << t << " samples drawn for edge" << endl;
+
+	return k_sum / t;
+}
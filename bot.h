@@ -1,56 +1,187 @@
-#ifndef BOT_H
-#define BOT_H
-
-#include<vector>
-#include "util.h"
-
-class Board;
-
-class Bot {
-public:
-	//Initialization and cleanup
-	void reset();
-	~Bot();
-	Bot();
-
-	//Set bot characteristics
-	void set_board(Board*);
-	void set_edge_search_limit(int size);
-	void set_edge_subset_approximation(bool approximate);
-
-	//Key method: select next move
-	MoveResult select_next_move();
-
-private:
-	//Cleanup
-	void free();
-
-	//General logical methods
-	bool check_queue_empty();
-	void single_square_search();
-	MoveResult guess_random_square();
-
-	//Edge search methods
-	void edge_search();
-	std::vector<std::vector<std::pair<int, int>>*>* get_edges();
-	double update_probabilities(std::vector<std::pair<int, int>>* edge);
-	double update_probabilities_precise(std::vector<std::pair<int, int>>* edge);
-	double update_probabilities_sectioned(std::vector<std::pair<int, int>>* edge);
-
-	//Board and board info
-	Board* board;
-	int m_rows;
-	int m_cols;
-	int m_mines;
-
-	//Settings
-	int MAX_SIZE;
-	bool edge_subset_approximation;
-
-	//State variables
-	std::vector<std::pair<int, int>> move_queue;
-	double** m_probabilities;
-	MoveResult last_result;
-};
-
+#ifndef BOT_H
+#define BOT_H
+
+#include<vector>
+#include<chrono>
+#include<random>
+#include<functional>
+#include<ostream>
+#include<atomic>
+#include "util.h"
+#include "guess_queue.h"
+#include "solution_cache.h"
+#include "model_counter.h"
+#include "task_pool.h"
+#include "cost_model.h"
+
+#define LOOKAHEAD_REGION 24 //Maximum number of squares counted when scoring a guess
+#define LOOKAHEAD_MARGIN 0.05 //Guesses more likely to be a mine than the best guess by more than this are not compared
+#define SECTIONED_NODE_BUDGET 100000 //Default maximum number of nodes of each sub-edge tree
+#define SECTIONED_MEMORY_BUDGET 512 //Default maximum memory of the sub-edge trees built at once in megabytes
+
+struct MemoryTracker { //Live and peak bytes of search structures, shared by a bot and its worker bots
+	std::atomic<long long> live;
+	std::atomic<long long> peak;
+};
+
+class BoardView;
+
+class Bot {
+	friend class PatternTableTest; //Compares the pattern table with the brute force search on random edges
+
+public:
+	//Initialization and cleanup
+	void reset();
+	~Bot();
+	Bot();
+
+	//Set bot characteristics
+	void set_board(BoardView*);
+	void set_edge_search_limit(int size);
+	void set_edge_subset_approximation(bool approximate);
+	void set_edge_reduction(bool reduce);
+	void set_model_counting(bool count);
+	void set_endgame_thresholds(int squares, int mines);
+	void set_lookahead(int candidates, double milliseconds);
+	void set_guessing(bool guess);
+	void set_verbose(bool verbose_output);
+	int get_edge_search_limit();
+	void set_move_time_budget(double milliseconds);
+	double get_move_time_budget();
+	SolverTier get_last_tier();
+	void set_sample_budget(int samples);
+	int get_sample_budget();
+	double get_confidence(int i, int j);
+	void set_solution_cache(SolutionCache* cache);
+	SolutionCache* get_solution_cache();
+	void set_search_threads(int threads);
+	int get_search_threads();
+	void set_sectioned_budget(int nodes, int megabytes);
+	long long get_peak_search_memory();
+	long long get_max_search_memory();
+	void set_cost_model(CostModel* model, double target_milliseconds);
+	CostModel* get_cost_model();
+	double get_move_target();
+	GameStats get_game_stats();
+	void set_random_seed(unsigned seed);
+	unsigned long long get_settings_hash();
+
+	//Key method: select next move
+	MoveResult select_next_move();
+	void analyze();
+	std::vector<std::pair<int, int>> get_safe_squares();
+	std::vector<std::pair<int, int>> get_best_guesses(int k);
+	double get_probability(int i, int j);
+
+private:
+	//Cleanup
+	void free();
+
+	//General logical methods
+	bool check_queue_empty();
+	void single_square_search();
+	void pairwise_search();
+	void single_square_search_generic();
+	void pairwise_search_generic();
+	template <int ROWS, int COLS> void single_square_search_fixed();
+	template <int ROWS, int COLS> void pairwise_search_fixed();
+	void select_kernels();
+	unsigned long long window_mask(int i, int j, int ci, int cj, std::vector<char>* deduced_safe, int* remaining);
+	MoveResult guess_random_square();
+	std::pair<int, int> lookahead_guess(std::pair<int, int> best_guess);
+	double lookahead_score(std::pair<int, int> guess, std::chrono::steady_clock::time_point deadline);
+
+	//Edge search methods
+	void edge_search();
+	std::vector<std::vector<std::pair<int, int>>*>* get_edges();
+	void search_edges_parallel(std::vector<std::vector<std::pair<int, int>>*>* edges, std::vector<int>* pending, std::vector<EdgeSolution>* solutions, std::vector<char>* searched, std::vector<std::vector<double>>* probabilities, std::vector<std::string>* logs);
+	void prepare_search_workers();
+	void run_tasks(int num_tasks, const std::function<void(int)>& task);
+	void track_memory(long long bytes);
+	void start_memory_tracking();
+	bool search_precisely(std::vector<std::pair<int, int>>* edge);
+	void set_edge_target(double fraction);
+	void end_phase(double* total, std::chrono::steady_clock::time_point* start);
+	void build_layout(std::vector<std::pair<int, int>>* squares, int constrained, EdgeLayout* layout);
+	bool endgame_search(std::vector<std::vector<std::pair<int, int>>*>* edges, std::vector<std::pair<int, int>>* updated_squares);
+	double update_probabilities(std::vector<std::pair<int, int>>* edge);
+	double update_probabilities_table(std::vector<std::pair<int, int>>* edge);
+	double update_probabilities_reduced(std::vector<std::pair<int, int>>* edge);
+	double update_probabilities_counted(std::vector<std::pair<int, int>>* edge);
+	double update_probabilities_cached(std::vector<std::pair<int, int>>* edge);
+	double update_probabilities_precise(std::vector<std::pair<int, int>>* edge);
+	double update_probabilities_sectioned(std::vector<std::pair<int, int>>* edge);
+	double update_probabilities_estimate(std::vector<std::pair<int, int>>* edge);
+	double update_probabilities_sampled(std::vector<std::pair<int, int>>* edge);
+
+	//Time budget methods
+	void set_edge_deadline(double fraction);
+	bool past_deadline();
+
+	//Board and board info
+	BoardView* board;
+	int m_rows;
+	int m_cols;
+	int m_mines;
+
+	//Settings
+	int MAX_SIZE;
+	bool edge_subset_approximation;
+	bool edge_reduction;
+	bool model_counting;
+	int endgame_squares;
+	int endgame_mines;
+	int lookahead_candidates;
+	double lookahead_time;
+	bool guessing;
+	bool verbose;
+	std::ostream* log_output; //Where verbose output is written, a buffer of the edge's output for worker bots, written in edge order by the owner
+	double time_budget;
+	int sample_budget;
+	SolutionCache* solution_cache;
+	TaskPool* task_pool; //Runs independent edges and sub-edges at once (nullptr to search serially)
+	int sectioned_node_budget;
+	long long sectioned_memory_budget; //In bytes
+	CostModel* cost_model; //Times of precise searches, shared across games (nullptr to not record them)
+	double move_target; //Time aimed for per move in milliseconds when choosing searches with the cost model (0 to use MAX_SIZE)
+
+	//Searches specialised for the board size
+	void (Bot::*single_square_kernel)();
+	void (Bot::*pairwise_kernel)();
+
+	//State variables
+	std::vector<std::pair<int, int>> move_queue;
+	double** m_probabilities; //Probabilities of edge squares
+	double interior_probability; //Probability shared by all other unknown squares
+	std::unordered_map<unsigned long long, EdgeSolution> edge_cache; //Solutions of the last edge search by edge fingerprint
+	std::unordered_map<unsigned long long, double> lookahead_cache; //Lookahead scores by guess and surroundings
+	std::vector<double> edge_histogram; //Possibilities by number of mines for the last precisely searched edge
+	std::vector<int> layout_index; //Index of each flat id among the squares or constraints of the layout being built, -1 when not in it
+	GuessQueue guess_queue;
+	ModelCounter model_counter;
+	std::unordered_map<std::pair<int, int>, double, PairHashStruct> m_confidence;
+	std::mt19937 m_rng;
+	MoveResult last_result;
+	SolverTier last_tier;
+	SolverTier search_tier;
+	std::chrono::steady_clock::time_point move_deadline;
+	std::chrono::steady_clock::time_point edge_deadline;
+	std::chrono::steady_clock::time_point target_deadline; //End of the move's target time
+	double edge_target; //Time of the target left for the current edge in milliseconds
+
+	//Bots searching edges on the task pool's threads, one per thread, sharing this bot's board and task pool
+	std::vector<Bot*> search_workers;
+	bool search_worker; //This bot is a worker of another bot, and does not own its task pool
+	bool defer_sampling; //Leave edges needing the sampling search (which draws from the shared random number generator) to the owner
+	bool sampling_deferred;
+
+	//Memory of the sub-edge trees, tracked for the current move
+	MemoryTracker own_memory;
+	MemoryTracker* search_memory; //Own tracker, or the owner's for a worker bot
+	long long max_search_memory; //Largest peak of any move since the last reset
+
+	//Moves and time of each search since the last reset
+	GameStats game_stats;
+};
+
 #endif //BOT_H
\ No newline at end of file
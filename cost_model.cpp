@@ -0,0 +1,207 @@
+#include "cost_model.h"
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <math.h>
+
+using namespace std;
+
+//Default fit of the log time in milliseconds, measured on the brute force search of edges on standard boards
+const static double DEFAULT_WEIGHTS[COST_MODEL_FEATURES]{ -8.5, 0.78, 0.77 };
+
+//Edges (size and constraints) at which the default fit is added as samples
+const static int DEFAULT_POINTS[3][2]{
+	{8,6},
+	{16,12},
+	{16,20}
+};
+
+//Constructor
+CostModel::CostModel() {
+	clear();
+}
+
+//Forget every recorded time, going back to the default fit
+void CostModel::clear() {
+	lock_guard<mutex> guard(m_lock);
+	for (int a = 0; a < COST_MODEL_FEATURES; a++) {
+		xty[a] = 0;
+		for (int b = 0; b < COST_MODEL_FEATURES; b++) {
+			xtx[a][b] = 0;
+		}
+	}
+	for (int k = 0; k < 3; k++) { //Default fit as samples, weighted so the first few recorded times can overrule it
+		double x[COST_MODEL_FEATURES];
+		features(DEFAULT_POINTS[k][0], DEFAULT_POINTS[k][1], x);
+		double y = 0;
+		for (int a = 0; a < COST_MODEL_FEATURES; a++) {
+			y += DEFAULT_WEIGHTS[a] * x[a];
+		}
+		for (int a = 0; a < COST_MODEL_FEATURES; a++) {
+			xty[a] += COST_MODEL_PRIOR * x[a] * y;
+			for (int b = 0; b < COST_MODEL_FEATURES; b++) {
+				xtx[a][b] += COST_MODEL_PRIOR * x[a] * x[b];
+			}
+		}
+	}
+	samples = 0;
+	squared_error = 0;
+	fit();
+}
+
+//Features of an edge: constant, number of squares and constraints per square
+void CostModel::features(int squares, int constraints, double* x) {
+	x[0] = 1;
+	x[1] = squares;
+	x[2] = squares > 0 ? (double)constraints / squares : 0;
+}
+
+//Solve the normal equations for the weights by Gaussian elimination (must hold the lock)
+void CostModel::fit() {
+	double a[COST_MODEL_FEATURES][COST_MODEL_FEATURES + 1];
+	for (int r = 0; r < COST_MODEL_FEATURES; r++) {
+		for (int c = 0; c < COST_MODEL_FEATURES; c++) {
+			a[r][c] = xtx[r][c];
+		}
+		a[r][COST_MODEL_FEATURES] = xty[r];
+	}
+	for (int c = 0; c < COST_MODEL_FEATURES; c++) {
+		int pivot = c;
+		for (int r = c + 1; r < COST_MODEL_FEATURES; r++) {
+			if (fabs(a[r][c]) > fabs(a[pivot][c])) {
+				pivot = r;
+			}
+		}
+		if (fabs(a[pivot][c]) < 1e-12) { //Singular, keep the previous weights
+			return;
+		}
+		for (int k = 0; k <= COST_MODEL_FEATURES; k++) {
+			swap(a[c][k], a[pivot][k]);
+		}
+		for (int r = 0; r < COST_MODEL_FEATURES; r++) {
+			if (r == c) {
+				continue;
+			}
+			double factor = a[r][c] / a[c][c];
+			for (int k = c; k <= COST_MODEL_FEATURES; k++) {
+				a[r][k] -= factor * a[c][k];
+			}
+		}
+	}
+	for (int r = 0; r < COST_MODEL_FEATURES; r++) {
+		weights[r] = a[r][COST_MODEL_FEATURES] / a[r][r];
+	}
+}
+
+//Add the time of a precise search of an edge with the given number of squares and constraints, and refit
+void CostModel::record(int squares, int constraints, double milliseconds) {
+	double x[COST_MODEL_FEATURES];
+	features(squares, constraints, x);
+	double y = log(max(milliseconds, COST_MODEL_MIN_TIME));
+	lock_guard<mutex> guard(m_lock);
+	double predicted = 0;
+	for (int a = 0; a < COST_MODEL_FEATURES; a++) {
+		predicted += weights[a] * x[a];
+	}
+	squared_error += (y - predicted) * (y - predicted);
+	samples += 1;
+	for (int a = 0; a < COST_MODEL_FEATURES; a++) {
+		xty[a] += x[a] * y;
+		for (int b = 0; b < COST_MODEL_FEATURES; b++) {
+			xtx[a][b] += x[a] * x[b];
+		}
+	}
+	fit();
+}
+
+//Predicted time of a precise search of an edge with the given number of squares and constraints in milliseconds
+double CostModel::predict(int squares, int constraints) {
+	double x[COST_MODEL_FEATURES];
+	features(squares, constraints, x);
+	lock_guard<mutex> guard(m_lock);
+	double y = 0;
+	for (int a = 0; a < COST_MODEL_FEATURES; a++) {
+		y += weights[a] * x[a];
+	}
+	return exp(y);
+}
+
+//Largest edge with the mean constraints per square of the samples predicted to take at most the given time (0 if none)
+int CostModel::largest_within(double milliseconds) {
+	double density;
+	{
+		lock_guard<mutex> guard(m_lock);
+		density = xtx[0][2] / xtx[0][0];
+	}
+	int size = 0;
+	for (int n = 1; n <= COST_MODEL_MAX_SIZE; n++) {
+		if (predict(n, (int)round(n * density)) <= milliseconds) {
+			size = n;
+		}
+	}
+	return size;
+}
+
+//Write the sums of the fit to a binary file
+bool CostModel::save(string path) {
+	lock_guard<mutex> guard(m_lock);
+	ofstream out(path, ios::binary);
+	if (!out) {
+		return false;
+	}
+	int num_features = COST_MODEL_FEATURES;
+	out.write((char*)&num_features, sizeof(int));
+	out.write((char*)&samples, sizeof(long long));
+	out.write((char*)&squared_error, sizeof(double));
+	out.write((char*)xtx, sizeof(xtx));
+	out.write((char*)xty, sizeof(xty));
+	return out.good();
+}
+
+//Read the sums of the fit from a binary file written by save, keeping the current fit if it cannot be read
+bool CostModel::load(string path) {
+	ifstream in(path, ios::binary);
+	if (!in) {
+		return false;
+	}
+	int num_features = 0;
+	long long file_samples;
+	double file_error;
+	double file_xtx[COST_MODEL_FEATURES][COST_MODEL_FEATURES];
+	double file_xty[COST_MODEL_FEATURES];
+	in.read((char*)&num_features, sizeof(int));
+	in.read((char*)&file_samples, sizeof(long long));
+	in.read((char*)&file_error, sizeof(double));
+	in.read((char*)file_xtx, sizeof(file_xtx));
+	in.read((char*)file_xty, sizeof(file_xty));
+	if (!in.good() || num_features != COST_MODEL_FEATURES) {
+		return false;
+	}
+	lock_guard<mutex> guard(m_lock);
+	samples = file_samples;
+	squared_error = file_error;
+	for (int a = 0; a < COST_MODEL_FEATURES; a++) {
+		xty[a] = file_xty[a];
+		for (int b = 0; b < COST_MODEL_FEATURES; b++) {
+			xtx[a][b] = file_xtx[a][b];
+		}
+	}
+	fit();
+	return true;
+}
+
+//Print out the fit and its typical error
+void CostModel::print_stats() {
+	lock_guard<mutex> guard(m_lock);
+	cout << "Cost model: " << samples << " samples, log time = " << weights[0] << " + " << weights[1] << " * squares + " << weights[2] << " * constraints per square";
+	if (samples > 0) {
+		cout << ", typical error x" << exp(sqrt(squared_error / samples));
+	}
+	cout << endl;
+}
+
+//Number of precise searches recorded
+long long CostModel::get_samples() {
+	lock_guard<mutex> guard(m_lock);
+	return samples;
+}
@@ -0,0 +1,48 @@
+#ifndef COST_MODEL_H
+#define COST_MODEL_H
+
+#include <string>
+#include <mutex>
+
+#define COST_MODEL_FEATURES 3 //Constant, edge size and constraints per square
+#define COST_MODEL_PRIOR 1.0 //Weight of each point of the default fit, in samples
+#define COST_MODEL_MAX_SIZE 30 //Largest edge ever searched precisely, as the brute force numbers its possibilities with an int
+#define COST_MODEL_MIN_TIME 0.001 //Shortest time recorded in milliseconds, below the clock's resolution
+
+//Online model of the time taken by the precise search of an edge, shared between bots and games
+//The logarithm of the time is fitted by least squares to the edge size and the number of constraints per square,
+//starting from a default fit that measured times quickly outweigh
+class CostModel {
+public:
+	//Initialization
+	CostModel();
+	void clear();
+
+	//Key methods: record the time of a precise search, and predict the time of another in milliseconds
+	void record(int squares, int constraints, double milliseconds);
+	double predict(int squares, int constraints);
+
+	//Largest edge (with the mean constraints per square of the samples) predicted to be searched within the given time
+	int largest_within(double milliseconds);
+
+	//Persistence
+	bool save(std::string path);
+	bool load(std::string path);
+
+	//Stats
+	void print_stats();
+	long long get_samples();
+
+private:
+	static void features(int squares, int constraints, double* x);
+	void fit();
+
+	std::mutex m_lock;
+	double xtx[COST_MODEL_FEATURES][COST_MODEL_FEATURES]; //Sums of products of the features of each sample
+	double xty[COST_MODEL_FEATURES]; //Sums of the features of each sample times its log time
+	double weights[COST_MODEL_FEATURES];
+	long long samples;
+	double squared_error; //Sum of squared errors of the log time of each sample, predicted before it was recorded
+};
+
+#endif //COST_MODEL_H
@@ -0,0 +1,181 @@
+#include "game_record.h"
+
+using namespace std;
+
+//Write a column of a block
+template <typename T> static void write_column(ofstream& out, const vector<T>& column) {
+	out.write((const char*)column.data(), column.size() * sizeof(T));
+}
+
+//Read a column of a block with the given number of values
+template <typename T> static void read_column(ifstream& in, vector<T>* column, long long count) {
+	column->resize(count);
+	in.read((char*)column->data(), count * sizeof(T));
+}
+
+//Add a game, packing its compressed seed into one bit per square
+void RecordBlock::add(const string& seed, MoveResult result, const GameStats& stats, long long memory) {
+	int squares = rows * cols;
+	int bytes = (squares + 7) / 8;
+	int start = layouts.size();
+	layouts.resize(start + bytes, 0);
+	int k = 0;
+	for (int i = 0; i + 1 < seed.length(); i += 2) { //Runs of a square state and their length
+		for (int j = 0; j < seed[i + 1] - '0' && k < squares; j++, k++) {
+			if (seed[i] == '1') {
+				layouts[start + k / 8] |= 1 << (k % 8);
+			}
+		}
+	}
+	results.push_back(result);
+	moves.push_back(stats.moves);
+	guesses.push_back(stats.guesses);
+	largest_edges.push_back(stats.largest_edge);
+	single_square_times.push_back(stats.single_square_time);
+	pairwise_times.push_back(stats.pairwise_time);
+	edge_times.push_back(stats.edge_time);
+	guess_times.push_back(stats.guess_time);
+	peak_memory.push_back(memory);
+}
+
+//Remove every game, keeping the memory of the columns
+void RecordBlock::clear() {
+	layouts.clear();
+	results.clear();
+	moves.clear();
+	guesses.clear();
+	largest_edges.clear();
+	single_square_times.clear();
+	pairwise_times.clear();
+	edge_times.clear();
+	guess_times.clear();
+	peak_memory.clear();
+}
+
+//Number of games in the block
+int RecordBlock::size() {
+	return results.size();
+}
+
+//Compressed seed of a game, in the same form as the board's seeds
+string RecordBlock::get_seed(int game) {
+	int squares = rows * cols;
+	const unsigned char* layout = layouts.data() + (long long)game * ((squares + 7) / 8);
+	string output("");
+	int run_start = 0;
+	for (int k = 1; k <= squares; k++) {
+		char prev = (layout[(k - 1) / 8] >> ((k - 1) % 8)) & 1 ? '1' : '0';
+		char curr = k < squares && (layout[k / 8] >> (k % 8)) & 1 ? '1' : '0';
+		if (k == squares || curr != prev || k - run_start == 9) {
+			output += prev;
+			output += '0' + k - run_start;
+			run_start = k;
+		}
+	}
+	return output;
+}
+
+//Constructor
+RecordWriter::RecordWriter() {
+	games = 0;
+}
+
+//Create the file and write its header, returns false if it cannot be created
+bool RecordWriter::open(string path) {
+	out.open(path, ios::binary);
+	if (!out) {
+		return false;
+	}
+	int header[2]{ RECORD_MAGIC, RECORD_VERSION };
+	out.write((char*)header, sizeof(header));
+	return out.good();
+}
+
+//Close the file once every thread has flushed its block
+void RecordWriter::close() {
+	out.close();
+}
+
+//Add a game to the thread's own block, writing the block once RECORD_BLOCK_GAMES games are buffered
+void RecordWriter::record(RecordBlock* block, const string& seed, MoveResult result, const GameStats& stats, long long memory) {
+	block->add(seed, result, stats, memory);
+	if (block->size() >= RECORD_BLOCK_GAMES) {
+		flush(block);
+	}
+}
+
+//Write the games of the block, column by column, and clear it
+void RecordWriter::flush(RecordBlock* block) {
+	int count = block->size();
+	if (count == 0) {
+		return;
+	}
+	{
+		lock_guard<mutex> guard(m_lock);
+		int header[3]{ block->rows, block->cols, count };
+		out.write((char*)header, sizeof(header));
+		write_column(out, block->layouts);
+		write_column(out, block->results);
+		write_column(out, block->moves);
+		write_column(out, block->guesses);
+		write_column(out, block->largest_edges);
+		write_column(out, block->single_square_times);
+		write_column(out, block->pairwise_times);
+		write_column(out, block->edge_times);
+		write_column(out, block->guess_times);
+		write_column(out, block->peak_memory);
+		games += count;
+	}
+	block->clear();
+}
+
+//Number of games written
+long long RecordWriter::get_games() {
+	lock_guard<mutex> guard(m_lock);
+	return games;
+}
+
+//Open a record file and check its header, returns false if it is not a record file of this version
+bool RecordReader::open(string path) {
+	in.open(path, ios::binary);
+	if (!in) {
+		return false;
+	}
+	in.seekg(0, ios::end);
+	file_size = in.tellg();
+	in.seekg(0, ios::beg);
+	int header[2]{ 0, 0 };
+	in.read((char*)header, sizeof(header));
+	return in.good() && header[0] == RECORD_MAGIC && header[1] == RECORD_VERSION;
+}
+
+//Read the next block, returns false at the end of the file (or if the block is cut short or corrupt)
+bool RecordReader::next(RecordBlock* block) {
+	int header[3];
+	in.read((char*)header, sizeof(header));
+	if (!in.good()) {
+		return false;
+	}
+	if (header[0] <= 0 || header[1] <= 0 || (long long)header[0] * header[1] > RECORD_MAX_SQUARES || header[2] <= 0 || header[2] > RECORD_BLOCK_GAMES) {
+		return false;
+	}
+	block->rows = header[0];
+	block->cols = header[1];
+	long long count = header[2];
+	long long layout_bytes = (block->rows * block->cols + 7) / 8;
+	long long game_bytes = layout_bytes + sizeof(unsigned char) + 3 * sizeof(int) + 4 * sizeof(float) + sizeof(long long);
+	if (count * game_bytes > file_size - (long long)in.tellg()) { //Cut short, or a corrupt header
+		return false;
+	}
+	read_column(in, &block->layouts, count * layout_bytes);
+	read_column(in, &block->results, count);
+	read_column(in, &block->moves, count);
+	read_column(in, &block->guesses, count);
+	read_column(in, &block->largest_edges, count);
+	read_column(in, &block->single_square_times, count);
+	read_column(in, &block->pairwise_times, count);
+	read_column(in, &block->edge_times, count);
+	read_column(in, &block->guess_times, count);
+	read_column(in, &block->peak_memory, count);
+	return in.good();
+}
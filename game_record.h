@@ -0,0 +1,69 @@
+#ifndef GAME_RECORD_H
+#define GAME_RECORD_H
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <fstream>
+#include "util.h"
+
+#define RECORD_MAGIC 0x4352534d //"MSRC" at the start of every record file
+#define RECORD_VERSION 1
+#define RECORD_BLOCK_GAMES 65536 //Games buffered by each thread before they are written as one block
+#define RECORD_MAX_SQUARES (1 << 16) //Largest board read from a record file (256x256), any larger is taken as a corrupt block
+
+//Records of a block of games, one vector per column
+//Layouts are packed as one bit per square (row by row) rather than stored as seeds, times are in microseconds
+struct RecordBlock {
+	int rows;
+	int cols;
+	std::vector<unsigned char> layouts;
+	std::vector<unsigned char> results;
+	std::vector<int> moves;
+	std::vector<int> guesses;
+	std::vector<int> largest_edges;
+	std::vector<float> single_square_times;
+	std::vector<float> pairwise_times;
+	std::vector<float> edge_times;
+	std::vector<float> guess_times;
+	std::vector<long long> peak_memory; //Largest memory of the sub-edge trees of any move in bytes
+
+	void add(const std::string& seed, MoveResult result, const GameStats& stats, long long memory);
+	void clear();
+	int size();
+	std::string get_seed(int game);
+};
+
+//Writes the records of several threads to one binary file, each thread buffering its games in its own block
+//Blocks are written whole, column by column, in the order they fill up, so games of different threads are interleaved by block
+class RecordWriter {
+public:
+	//Initialization and cleanup
+	RecordWriter();
+	bool open(std::string path);
+	void close();
+
+	//Key method: add a game to the thread's block, writing the block once it is full
+	void record(RecordBlock* block, const std::string& seed, MoveResult result, const GameStats& stats, long long memory);
+	void flush(RecordBlock* block);
+
+	long long get_games();
+
+private:
+	std::mutex m_lock;
+	std::ofstream out;
+	long long games;
+};
+
+//Block by block reading of a file written by RecordWriter
+class RecordReader {
+public:
+	bool open(std::string path);
+	bool next(RecordBlock* block);
+
+private:
+	std::ifstream in;
+	long long file_size;
+};
+
+#endif //GAME_RECORD_H
@@ -0,0 +1,176 @@
+#include "generator.h"
+#include "board.h"
+#include "bot.h"
+#include "util.h"
+#include <iostream>
+#include <chrono>
+#include <time.h>
+#include <omp.h>
+
+using namespace std;
+
+//Constructor for default values
+//Mines are never placed on the opening square (0, 0), or its neighbours when the board has room
+Generator::Generator(int rows, int columns, int num_mines)
+	: m_rows(rows), m_cols(columns), m_mines(num_mines)
+{
+	MAX_SIZE = 10;
+	max_repairs = 20;
+	boards_generated = 0;
+	attempts = 0;
+	repairs = 0;
+	rejections = 0;
+	elapsed = 0;
+
+	bool clear_opening = m_mines <= m_rows * m_cols - 4;
+	for (int k = 0; k < m_rows * m_cols; k++) {
+		if (k == 0 || (clear_opening && k / m_cols <= 1 && k % m_cols <= 1)) {
+			continue;
+		}
+		m_candidates.push_back(k);
+	}
+}
+
+//Set maximum edge length for the checking bot
+void Generator::set_edge_search_limit(int size) {
+	MAX_SIZE = size;
+}
+
+//Set number of times a board is repaired before being rejected
+void Generator::set_max_repairs(int repairs) {
+	max_repairs = repairs;
+}
+
+//Generate boards in parallel until the requested number pass the no-guess check
+//Each thread owns a quiet board and bot, reused across attempts
+//Returns number of boards generated, appending their compressed seeds to the output vector
+int Generator::generate(int num_boards, vector<string>* seeds) {
+	boards_generated = 0;
+	attempts = 0;
+	repairs = 0;
+	rejections = 0;
+	elapsed = 0;
+	if (m_mines >= m_rows * m_cols || m_mines > m_candidates.size()) {
+		cout << "Error: bad number of mines" << endl;
+		return 0;
+	}
+
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	unsigned base_seed = (unsigned)time(NULL);
+
+	#pragma omp parallel num_threads(NUM_THREADS)
+	{
+		mt19937 rng(base_seed + omp_get_thread_num());
+		Board* board = nullptr;
+		bool done = false;
+		while (!done) {
+			string layout = random_layout(rng);
+			if (board == nullptr) {
+				board = new Board(m_rows, m_cols, m_mines, Board::compress_seed(layout), false);
+				board->get_bot()->set_edge_search_limit(MAX_SIZE);
+				board->get_bot()->set_guessing(false);
+			}
+			else {
+				board->load_seed(layout);
+			}
+
+			int board_repairs = 0;
+			MoveResult res = play(board);
+			while (res == GUESS_REQUIRED && board_repairs < max_repairs && repair(board, layout, rng)) { //Move mines off the stuck frontier and replay
+				board_repairs += 1;
+				board->load_seed(layout);
+				res = play(board);
+			}
+
+			#pragma omp critical
+			{
+				attempts += 1;
+				repairs += board_repairs;
+				if (boards_generated >= num_boards) { //Another thread finished the batch
+					done = true;
+				}
+				else if (res == WIN) {
+					seeds->push_back(board->get_seed());
+					boards_generated += 1;
+					done = boards_generated >= num_boards;
+				}
+				else {
+					rejections += 1;
+				}
+			}
+		}
+		delete board;
+	}
+
+	elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+	return boards_generated;
+}
+
+//Print out stats of the last generation run
+void Generator::print_stats() {
+	cout << "Generated " << boards_generated << " boards in " << elapsed << " seconds (" << get_boards_per_second() << " boards/sec)" << endl;
+	cout << "Attempts: " << attempts << endl;
+	cout << "Repairs: " << repairs << endl;
+	cout << "Rejected: " << rejections << endl;
+}
+
+//Throughput of the last generation run
+double Generator::get_boards_per_second() {
+	if (elapsed <= 0) {
+		return 0;
+	}
+	return boards_generated / elapsed;
+}
+
+//Generate uncompressed seed with mines placed uniformly over the candidate squares
+string Generator::random_layout(mt19937& rng) {
+	string seed(m_rows * m_cols, '0');
+	vector<int> candidates = m_candidates;
+	for (int k = 0; k < m_mines; k++) { //Partial Fisher-Yates shuffle
+		uniform_int_distribution<int> dist(k, candidates.size() - 1);
+		swap(candidates[k], candidates[dist(rng)]);
+		seed[candidates[k]] = '1';
+	}
+	return seed;
+}
+
+//Play from the opening square using only deductions
+//Returns WIN if the board was cleared, GUESS_REQUIRED at the first forced guess
+MoveResult Generator::play(Board* b) {
+	MoveResult res = b->make_move(0, 0);
+	while (res == CONTINUE) {
+		res = b->get_bot()->select_next_move();
+	}
+	return res;
+}
+
+//Move a random mine on the frontier (unknown squares bordering revealed squares) to a random square away from the frontier
+//Returns false if there is no such pair of squares, in which case the board is rejected
+bool Generator::repair(Board* b, string& layout, mt19937& rng) {
+	vector<int> frontier_mines;
+	vector<int> interior_safe;
+	for (int i = 0; i < m_rows; i++) {
+		for (int j = 0; j < m_cols; j++) {
+			if (b->is_known(i, j) || (i <= 1 && j <= 1)) {
+				continue;
+			}
+			int revealed = 0;
+			execute_callback(b, i, j, &count_safe_spaces, &revealed);
+			if (revealed > 0 && layout[i * m_cols + j] == '1') {
+				frontier_mines.push_back(i * m_cols + j);
+			}
+			else if (revealed == 0 && layout[i * m_cols + j] == '0') {
+				interior_safe.push_back(i * m_cols + j);
+			}
+		}
+	}
+	if (frontier_mines.empty() || interior_safe.empty()) {
+		return false;
+	}
+
+	uniform_int_distribution<int> from(0, frontier_mines.size() - 1);
+	uniform_int_distribution<int> to(0, interior_safe.size() - 1);
+	layout[frontier_mines[from(rng)]] = '0';
+	layout[interior_safe[to(rng)]] = '1';
+	return true;
+}
@@ -0,0 +1,51 @@
+#ifndef GENERATOR_H
+#define GENERATOR_H
+
+#include <string>
+#include <vector>
+#include <random>
+#include "util.h"
+
+class Board;
+
+class Generator {
+public:
+	//Initialization
+	Generator(int rows, int columns, int num_mines);
+
+	//Set generator characteristics
+	void set_edge_search_limit(int size);
+	void set_max_repairs(int repairs);
+
+	//Key method: generate boards the bot can solve without guessing
+	int generate(int num_boards, std::vector<std::string>* seeds);
+
+	//Stats of the last call to generate
+	void print_stats();
+	double get_boards_per_second();
+
+private:
+	//Board creation and checking
+	std::string random_layout(std::mt19937& rng);
+	MoveResult play(Board* b);
+	bool repair(Board* b, std::string& layout, std::mt19937& rng);
+
+	//Board setup values
+	int m_rows;
+	int m_cols;
+	int m_mines;
+	std::vector<int> m_candidates;
+
+	//Settings
+	int MAX_SIZE;
+	int max_repairs;
+
+	//Stats
+	int boards_generated;
+	int attempts;
+	int repairs;
+	int rejections;
+	double elapsed;
+};
+
+#endif //GENERATOR_H
@@ -0,0 +1,226 @@
+#include "guess_queue.h"
+#include "board_view.h"
+#include <queue>
+
+using namespace std;
+
+//Compute spiral order for the board and start with every square in the interior
+void GuessQueue::reset(int rows, int cols) {
+	m_rows = rows;
+	m_cols = cols;
+	spiral_index.assign(rows * cols, 0);
+	spiral_cells.assign(rows * cols, 0);
+	heap.clear();
+	heap_position.assign(rows * cols, -1);
+	probabilities.assign(rows * cols, 0);
+	interior.clear();
+	interior_probability = 0;
+
+	//Spiral traversal, as the original full scan
+	int top = 0, bottom = m_rows - 1, left = 0, right = m_cols - 1;
+	int dir = 0;
+	int ind = 0;
+	while (top <= bottom && left <= right) {
+		if (dir == 0) {
+			for (int i = left; i <= right; i++) { //left to right
+				spiral_cells[ind++] = top * m_cols + i;
+			}
+			top++;
+		}
+		else if (dir == 1) {
+			for (int i = top; i <= bottom; i++) { //Top to bottom
+				spiral_cells[ind++] = i * m_cols + right;
+			}
+			right -= 1;
+		}
+		else if (dir == 2) {
+			for (int i = right; i >= left; i--) { //Right to left
+				spiral_cells[ind++] = bottom * m_cols + i;
+			}
+			bottom -= 1;
+		}
+		else {
+			for (int i = bottom; i >= top; i--) { //Left to top
+				spiral_cells[ind++] = i * m_cols + left;
+			}
+			left += 1;
+		}
+		dir = (dir + 1) % 4;
+	}
+	for (int k = 0; k < ind; k++) {
+		spiral_index[spiral_cells[k]] = k;
+		interior.insert(interior.end(), k);
+	}
+}
+
+//Set probability of an edge square, moving it out of the interior if needed (logarithmic time)
+void GuessQueue::update(int i, int j, double probability) {
+	int cell = i * m_cols + j;
+	interior.erase(spiral_index[cell]);
+	if (heap_position[cell] == -1) {
+		probabilities[cell] = probability;
+		heap_position[cell] = heap.size();
+		heap.push_back(cell);
+		sift_up(heap_position[cell]);
+	}
+	else if (probability < probabilities[cell]) {
+		probabilities[cell] = probability;
+		sift_up(heap_position[cell]);
+	}
+	else if (probability > probabilities[cell]) {
+		probabilities[cell] = probability;
+		sift_down(heap_position[cell]);
+	}
+}
+
+//Move a square back to the interior (no longer part of any edge)
+void GuessQueue::set_interior(int i, int j) {
+	int cell = i * m_cols + j;
+	heap_remove(cell);
+	interior.insert(spiral_index[cell]);
+}
+
+//Set shared probability of all interior squares
+void GuessQueue::set_interior_probability(double probability) {
+	interior_probability = probability;
+}
+
+//Get all squares currently treated as edge squares
+vector<pair<int, int>> GuessQueue::edge_squares() {
+	vector<pair<int, int>> squares;
+	for (int cell : heap) {
+		squares.push_back(make_pair(cell / m_cols, cell % m_cols));
+	}
+	return squares;
+}
+
+//Check if a square is treated as an edge square
+bool GuessQueue::is_edge(int i, int j) {
+	return heap_position[i * m_cols + j] != -1;
+}
+
+//Get the unknown square least likely to be a mine
+//Returns false if there are no unknown squares
+bool GuessQueue::best_guess(BoardView* board, pair<int, int>* square, double* probability) {
+	drop_known(board);
+	bool edge = !heap.empty();
+	bool inner = !interior.empty();
+	if (!edge && !inner) {
+		return false;
+	}
+	int cell;
+	if (edge && (!inner || probabilities[heap[0]] < interior_probability || (probabilities[heap[0]] == interior_probability && spiral_index[heap[0]] < *interior.begin()))) {
+		cell = heap[0];
+		*probability = probabilities[cell];
+	}
+	else {
+		cell = spiral_cells[*interior.begin()];
+		*probability = interior_probability;
+	}
+	*square = make_pair(cell / m_cols, cell % m_cols);
+	return true;
+}
+
+//Get the k unknown squares least likely to be mines, best first
+//Walks the top of the heap without modifying it (k log k time)
+vector<pair<int, int>> GuessQueue::best_guesses(BoardView* board, int k) {
+	drop_known(board);
+	vector<pair<int, int>> guesses;
+
+	//Candidate heap positions ordered by key, smallest first
+	auto compare = [this](int a, int b) { return less(heap[b], heap[a]); };
+	priority_queue<int, vector<int>, decltype(compare)> frontier(compare);
+	if (!heap.empty()) {
+		frontier.push(0);
+	}
+	set<int>::iterator itr = interior.begin();
+	while (guesses.size() < k && (!frontier.empty() || itr != interior.end())) {
+		int cell;
+		bool take_edge = false;
+		if (!frontier.empty()) {
+			int top = heap[frontier.top()];
+			take_edge = itr == interior.end() || probabilities[top] < interior_probability || (probabilities[top] == interior_probability && spiral_index[top] < *itr);
+		}
+		if (take_edge) {
+			int pos = frontier.top();
+			frontier.pop();
+			cell = heap[pos];
+			for (int child = 2 * pos + 1; child <= 2 * pos + 2 && child < heap.size(); child++) {
+				frontier.push(child);
+			}
+		}
+		else {
+			cell = spiral_cells[*itr];
+			itr++;
+		}
+		if (!board->is_known(cell / m_cols, cell % m_cols)) { //Only the top of the heap and front of the interior were checked
+			guesses.push_back(make_pair(cell / m_cols, cell % m_cols));
+		}
+	}
+	return guesses;
+}
+
+//Compare keys of two squares (probability, then spiral order)
+bool GuessQueue::less(int a, int b) {
+	if (probabilities[a] != probabilities[b]) {
+		return probabilities[a] < probabilities[b];
+	}
+	return spiral_index[a] < spiral_index[b];
+}
+
+//Move heap entry up until heap is ordered
+void GuessQueue::sift_up(int pos) {
+	while (pos > 0 && less(heap[pos], heap[(pos - 1) / 2])) {
+		swap(heap[pos], heap[(pos - 1) / 2]);
+		heap_position[heap[pos]] = pos;
+		heap_position[heap[(pos - 1) / 2]] = (pos - 1) / 2;
+		pos = (pos - 1) / 2;
+	}
+}
+
+//Move heap entry down until heap is ordered
+void GuessQueue::sift_down(int pos) {
+	while (true) {
+		int smallest = pos;
+		for (int child = 2 * pos + 1; child <= 2 * pos + 2 && child < heap.size(); child++) {
+			if (less(heap[child], heap[smallest])) {
+				smallest = child;
+			}
+		}
+		if (smallest == pos) {
+			return;
+		}
+		swap(heap[pos], heap[smallest]);
+		heap_position[heap[pos]] = pos;
+		heap_position[heap[smallest]] = smallest;
+		pos = smallest;
+	}
+}
+
+//Remove square from the heap if it is there
+void GuessQueue::heap_remove(int cell) {
+	int pos = heap_position[cell];
+	if (pos == -1) {
+		return;
+	}
+	heap_position[cell] = -1;
+	int last = heap.back();
+	heap.pop_back();
+	if (pos < heap.size()) {
+		heap[pos] = last;
+		heap_position[last] = pos;
+		sift_up(pos);
+		sift_down(heap_position[last]);
+	}
+}
+
+//Remove known squares from the top of the heap and front of the interior
+//Each square is removed at most once, so the cost is amortized over the game
+void GuessQueue::drop_known(BoardView* board) {
+	while (!heap.empty() && board->is_known(heap[0] / m_cols, heap[0] % m_cols)) {
+		heap_remove(heap[0]);
+	}
+	while (!interior.empty() && board->is_known(spiral_cells[*interior.begin()] / m_cols, spiral_cells[*interior.begin()] % m_cols)) {
+		interior.erase(interior.begin());
+	}
+}
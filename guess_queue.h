@@ -0,0 +1,51 @@
+#ifndef GUESS_QUEUE_H
+#define GUESS_QUEUE_H
+
+#include <vector>
+#include <set>
+#include "util.h"
+
+class BoardView;
+
+//Priority structure of unknown squares for guessing, ordered by probability of being a mine, then spiral order
+//(squares closest to the sides of the board first)
+//Edge squares are kept in an indexed heap so updates only touch changed squares
+//Interior squares share one probability and are kept in spiral order
+class GuessQueue {
+public:
+	//Initialization
+	void reset(int rows, int cols);
+
+	//Updates from edge search
+	void update(int i, int j, double probability);
+	void set_interior(int i, int j);
+	void set_interior_probability(double probability);
+	std::vector<std::pair<int, int>> edge_squares();
+	bool is_edge(int i, int j);
+
+	//Queries, removing squares that have become known along the way
+	bool best_guess(BoardView* board, std::pair<int, int>* square, double* probability);
+	std::vector<std::pair<int, int>> best_guesses(BoardView* board, int k);
+
+private:
+	//Heap methods
+	bool less(int a, int b);
+	void sift_up(int pos);
+	void sift_down(int pos);
+	void heap_remove(int cell);
+	void drop_known(BoardView* board);
+
+	int m_rows;
+	int m_cols;
+	std::vector<int> spiral_index; //Position of each square in the spiral traversal
+	std::vector<int> spiral_cells; //Square at each position of the spiral traversal
+
+	std::vector<int> heap; //Edge squares
+	std::vector<int> heap_position; //Position of each square in the heap, -1 if not in the heap
+	std::vector<double> probabilities;
+
+	std::set<int> interior; //Spiral indices of interior squares
+	double interior_probability;
+};
+
+#endif //GUESS_QUEUE_H
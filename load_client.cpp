@@ -0,0 +1,251 @@
+// load_client.cpp : Load generator for the minesweeper server mode.
+// Starts the server as a child process, keeps many games in flight, and reports throughput and tail latency.
+//
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <chrono>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <csignal>
+#include <unistd.h>
+#include <sys/wait.h>
+
+using namespace std;
+
+struct PendingRequest { //Request sent and not yet answered
+	string command;
+	int slot;
+	chrono::steady_clock::time_point sent;
+};
+
+struct GameSlot { //One of the games kept in flight
+	int id;
+	int moves;
+};
+
+int to_server;
+long long next_tag = 1;
+unordered_map<long long, PendingRequest> pending;
+
+//Send a request for the given slot, remembering when it was sent
+void send_request(string command, string args, int slot) {
+	long long tag = next_tag++;
+	string line = to_string(tag) + " " + command + (args.empty() ? "" : " " + args) + "\n";
+	pending[tag] = { command, slot, chrono::steady_clock::now() };
+	size_t written = 0;
+	while (written < line.length()) {
+		ssize_t res = write(to_server, line.c_str() + written, line.length() - written);
+		if (res <= 0) {
+			cout << "Server closed the connection" << endl;
+			exit(EPIPE);
+		}
+		written += res;
+	}
+}
+
+//Value at the given fraction of sorted samples
+double percentile(const vector<double>& sorted, double fraction) {
+	if (sorted.empty()) {
+		return 0;
+	}
+	return sorted[(int)(fraction * (sorted.size() - 1) + 0.5)];
+}
+
+//Set value from string
+void set_value(char* arg, int& val) {
+	try {
+		val = stoi(arg);
+	}
+	catch (const std::exception& e) {
+		cout << "Invalid argument" << endl;
+		exit(EINVAL);
+	}
+}
+
+//Main method
+int main(int argc, char** argv)
+{
+	signal(SIGPIPE, SIG_IGN); //Report a closed server instead of exiting
+
+	//Parse arguments, anything after "--" is passed on to the server
+	string server_path = "./minesweeper";
+	int concurrent = 64;
+	int total = 1000;
+	int rows = 9;
+	int cols = 9;
+	int mines = 10;
+	vector<string> server_args;
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--") == 0) {
+			for (i++; i < argc; i++) {
+				server_args.push_back(argv[i]);
+			}
+		}
+		else if (i + 1 < argc && (strcmp(argv[i], "-s") == 0 || strcmp(argv[i], "--server") == 0)) {
+			server_path = argv[++i];
+		}
+		else if (i + 1 < argc && (strcmp(argv[i], "-g") == 0 || strcmp(argv[i], "--concurrent") == 0)) {
+			set_value(argv[++i], concurrent);
+		}
+		else if (i + 1 < argc && (strcmp(argv[i], "-n") == 0 || strcmp(argv[i], "--games") == 0)) {
+			set_value(argv[++i], total);
+		}
+		else if (i + 1 < argc && (strcmp(argv[i], "-r") == 0 || strcmp(argv[i], "--rows") == 0)) {
+			set_value(argv[++i], rows);
+		}
+		else if (i + 1 < argc && (strcmp(argv[i], "-c") == 0 || strcmp(argv[i], "--columns") == 0)) {
+			set_value(argv[++i], cols);
+		}
+		else if (i + 1 < argc && (strcmp(argv[i], "-m") == 0 || strcmp(argv[i], "--mines") == 0)) {
+			set_value(argv[++i], mines);
+		}
+		else {
+			cout << "Generate load on the minesweeper server, playing games with the bot and reporting throughput and latency." << endl;
+			cout << "Options:" << endl;
+			cout << "	--server (-s) [file]: Set the server executable (default ./minesweeper)" << endl;
+			cout << "	--concurrent (-g) [int]: Set the number of games in flight at once (default 64)" << endl;
+			cout << "	--games (-n) [int]: Set the total number of games to play (default 1000)" << endl;
+			cout << "	--rows (-r) [int], --columns (-c) [int], --mines (-m) [int]: Set the board size (default 9x9 with 10 mines)" << endl;
+			cout << "	-- [options]: Pass the remaining options to the server" << endl;
+			return strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0 ? 0 : EINVAL;
+		}
+	}
+	concurrent = max(1, min(concurrent, total));
+
+	//Start the server with its stdin and stdout connected to pipes
+	int requests[2];
+	int responses[2];
+	if (pipe(requests) != 0 || pipe(responses) != 0) {
+		cout << "Could not create pipes" << endl;
+		return 1;
+	}
+	pid_t pid = fork();
+	if (pid == 0) {
+		dup2(requests[0], STDIN_FILENO);
+		dup2(responses[1], STDOUT_FILENO);
+		close(requests[0]);
+		close(requests[1]);
+		close(responses[0]);
+		close(responses[1]);
+		vector<char*> args;
+		args.push_back((char*)server_path.c_str());
+		args.push_back((char*)"--server");
+		for (string& arg : server_args) {
+			args.push_back((char*)arg.c_str());
+		}
+		args.push_back(nullptr);
+		execv(server_path.c_str(), args.data());
+		cerr << "Could not start server " << server_path << endl;
+		_exit(1);
+	}
+	close(requests[0]);
+	close(responses[1]);
+	to_server = requests[1];
+	FILE* from_server = fdopen(responses[0], "r");
+
+	//Keep the given number of games in flight, opening a new game whenever one ends
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	string board_args = to_string(rows) + " " + to_string(cols) + " " + to_string(mines);
+	vector<GameSlot> slots(concurrent, { -1, 0 });
+	int games_started = 0;
+	int games_finished = 0;
+	int wins = 0;
+	int errors = 0;
+	long long moves = 0;
+	vector<double> latencies;
+	for (int k = 0; k < concurrent; k++) {
+		send_request("new", board_args, k);
+		games_started += 1;
+	}
+
+	string server_stats;
+	char* buffer = nullptr;
+	size_t capacity = 0;
+	while (!pending.empty() && getline(&buffer, &capacity, from_server) > 0) {
+		chrono::steady_clock::time_point received = chrono::steady_clock::now();
+		istringstream response(buffer);
+		long long tag;
+		string status;
+		string value;
+		response >> tag >> status >> value;
+		unordered_map<long long, PendingRequest>::iterator it = pending.find(tag);
+		if (it == pending.end()) {
+			cout << "Unexpected response: " << buffer;
+			continue;
+		}
+		PendingRequest request = it->second;
+		pending.erase(it);
+		latencies.push_back(chrono::duration<double, micro>(received - request.sent).count());
+		if (status != "ok") {
+			errors += 1;
+		}
+		if (request.command == "stats") {
+			string line = buffer;
+			server_stats = line.substr(line.find(" ok ") + 4);
+			continue;
+		}
+		if (request.slot < 0) {
+			continue;
+		}
+
+		GameSlot& slot = slots[request.slot];
+		bool game_over = false;
+		if (request.command == "new") {
+			if (status == "ok") {
+				slot.id = stoi(value);
+				slot.moves = 0;
+				send_request("next", to_string(slot.id), request.slot);
+			}
+			else {
+				game_over = true;
+			}
+		}
+		else if (request.command == "next") {
+			moves += 1;
+			slot.moves += 1;
+			if (status == "ok" && value == "continue") {
+				send_request("next", to_string(slot.id), request.slot);
+			}
+			else {
+				wins += status == "ok" && value == "win";
+				send_request("close", to_string(slot.id), -1);
+				game_over = true;
+			}
+		}
+		if (game_over) {
+			games_finished += 1;
+			if (games_started < total) {
+				send_request("new", board_args, request.slot);
+				games_started += 1;
+			}
+			else if (games_finished == total) {
+				send_request("stats", "", -1);
+			}
+		}
+	}
+	double elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+	free(buffer);
+
+	//Close the server and wait for it to finish
+	close(to_server);
+	fclose(from_server);
+	waitpid(pid, nullptr, 0);
+
+	//Report throughput and latency percentiles
+	sort(latencies.begin(), latencies.end());
+	cout << "Played " << games_finished << " games (" << wins << " won) with " << concurrent << " in flight in " << elapsed << " seconds" << endl;
+	cout << "Requests: " << latencies.size() << " (" << errors << " errors, " << moves << " moves)" << endl;
+	cout << "Throughput: " << latencies.size() / elapsed << " requests/sec, " << moves / elapsed << " moves/sec, " << games_finished / elapsed << " games/sec" << endl;
+	cout << "Latency (microseconds): p50 " << percentile(latencies, 0.5) << ", p90 " << percentile(latencies, 0.9) << ", p99 " << percentile(latencies, 0.99);
+	cout << ", p99.9 " << percentile(latencies, 0.999) << ", max " << (latencies.empty() ? 0 : latencies.back()) << endl;
+	if (!server_stats.empty()) {
+		cout << "Server: " << server_stats;
+	}
+	return pending.empty() ? 0 : 1;
+}
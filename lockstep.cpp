@@ -0,0 +1,422 @@
+#include "lockstep.h"
+#include "board.h"
+#include "bot.h"
+#include "pattern_table.h"
+#include <iostream>
+#include <chrono>
+
+using namespace std;
+
+//Mask of the squares of one word of a plane, leaving out the given column (-1 for none)
+static constexpr uint64_t column_mask(int col, bool high) {
+	uint64_t mask = 0;
+	int first = high ? 64 : 0;
+	int last = high ? LOCKSTEP_SQUARES : 64;
+	for (int p = first; p < last; p++) {
+		if (p % LOCKSTEP_COLS != col) {
+			mask |= 1ULL << (p - first);
+		}
+	}
+	return mask;
+}
+
+constexpr uint64_t HI_MASK = column_mask(-1, true);
+constexpr uint64_t NOT_FIRST_LO = column_mask(0, false);
+constexpr uint64_t NOT_FIRST_HI = column_mask(0, true);
+constexpr uint64_t NOT_LAST_LO = column_mask(LOCKSTEP_COLS - 1, false);
+constexpr uint64_t NOT_LAST_HI = column_mask(LOCKSTEP_COLS - 1, true);
+
+//Squares whose neighbour N squares further on (in row-major order) is set
+template <int N>
+inline void shift_down(uint64_t lo, uint64_t hi, uint64_t& out_lo, uint64_t& out_hi) {
+	out_lo = (lo >> N) | (hi << (64 - N));
+	out_hi = hi >> N;
+}
+
+//Squares whose neighbour N squares back (in row-major order) is set
+template <int N>
+inline void shift_up(uint64_t lo, uint64_t hi, uint64_t& out_lo, uint64_t& out_hi) {
+	out_lo = lo << N;
+	out_hi = ((hi << N) | (lo >> (64 - N))) & HI_MASK;
+}
+
+//Call the function with the plane of squares having a set neighbour, for each of the 8 directions
+//Shifts across a row end are masked off so that the first and last columns do not wrap around
+template <class F>
+inline void for_each_neighbour(uint64_t lo, uint64_t hi, F f) {
+	uint64_t n_lo, n_hi;
+	shift_up<LOCKSTEP_COLS + 1>(lo, hi, n_lo, n_hi);
+	f(n_lo & NOT_FIRST_LO, n_hi & NOT_FIRST_HI);
+	shift_up<LOCKSTEP_COLS>(lo, hi, n_lo, n_hi);
+	f(n_lo, n_hi);
+	shift_up<LOCKSTEP_COLS - 1>(lo, hi, n_lo, n_hi);
+	f(n_lo & NOT_LAST_LO, n_hi & NOT_LAST_HI);
+	shift_up<1>(lo, hi, n_lo, n_hi);
+	f(n_lo & NOT_FIRST_LO, n_hi & NOT_FIRST_HI);
+	shift_down<1>(lo, hi, n_lo, n_hi);
+	f(n_lo & NOT_LAST_LO, n_hi & NOT_LAST_HI);
+	shift_down<LOCKSTEP_COLS - 1>(lo, hi, n_lo, n_hi);
+	f(n_lo & NOT_FIRST_LO, n_hi & NOT_FIRST_HI);
+	shift_down<LOCKSTEP_COLS>(lo, hi, n_lo, n_hi);
+	f(n_lo, n_hi);
+	shift_down<LOCKSTEP_COLS + 1>(lo, hi, n_lo, n_hi);
+	f(n_lo & NOT_LAST_LO, n_hi & NOT_LAST_HI);
+}
+
+//Add one to the bit-sliced count of each square set in the plane
+inline void add_plane(uint64_t* sum_lo, uint64_t* sum_hi, uint64_t lo, uint64_t hi) {
+	for (int b = 0; b < LOCKSTEP_COUNT_BITS; b++) {
+		uint64_t carry_lo = sum_lo[b] & lo;
+		uint64_t carry_hi = sum_hi[b] & hi;
+		sum_lo[b] ^= lo;
+		sum_hi[b] ^= hi;
+		lo = carry_lo;
+		hi = carry_hi;
+	}
+}
+
+//Squares with a set neighbour in any direction
+inline void dilate(uint64_t lo, uint64_t hi, uint64_t& out_lo, uint64_t& out_hi) {
+	out_lo = 0;
+	out_hi = 0;
+	for_each_neighbour(lo, hi, [&](uint64_t n_lo, uint64_t n_hi) {
+		out_lo |= n_lo;
+		out_hi |= n_hi;
+	});
+}
+
+//Initialization, with no games in progress
+LockstepSimulator::LockstepSimulator(int num_mines)
+	: m_mines(num_mines)
+{
+	MAX_SIZE = 10;
+	time_budget = 0;
+	sample_budget = 0;
+	for (int k = 0; k < LOCKSTEP_LANES; k++) {
+		active[k] = false;
+		boards[k] = nullptr;
+		board_loaded[k] = false;
+	}
+	games_started = 0;
+	games_played = 0;
+	games_won = 0;
+	steps = 0;
+	scalar_moves = 0;
+	elapsed = 0;
+}
+
+//Cleanup of the scalar boards
+LockstepSimulator::~LockstepSimulator() {
+	for (int k = 0; k < LOCKSTEP_LANES; k++) {
+		delete boards[k];
+	}
+}
+
+//Set maximum edge length of the scalar bots
+void LockstepSimulator::set_edge_search_limit(int size) {
+	MAX_SIZE = size;
+}
+
+//Set time allowed for each scalar bot move in milliseconds (0 for no limit)
+void LockstepSimulator::set_move_time_budget(double milliseconds) {
+	time_budget = milliseconds;
+}
+
+//Set number of samples the scalar bots use for large edges (0 to disable sampling)
+void LockstepSimulator::set_sample_budget(int samples) {
+	sample_budget = samples;
+}
+
+//Play games in lanes until the given number are done, starting a new game in each lane as its game ends
+//Each step reveals the safe squares found in the last step (with flood reveals), then checks every lane for single-square deductions
+//Lanes without any deduction make one move with the scalar bot, which also searches edges and guesses
+//Returns number of games won
+int LockstepSimulator::simulate(int num_games, unsigned seed) {
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	rng.seed(seed);
+	games_target = num_games;
+	games_started = 0;
+	games_played = 0;
+	games_won = 0;
+	steps = 0;
+	scalar_moves = 0;
+	if (m_mines >= LOCKSTEP_SQUARES) {
+		cout << "Error: bad number of mines" << endl;
+		return 0;
+	}
+
+	//The bot's first guess does not depend on the layout, so it is made in the lanes without the scalar bot
+	Board empty(LOCKSTEP_ROWS, LOCKSTEP_COLS, m_mines, "", false);
+	empty.get_bot()->analyze();
+	vector<pair<int, int>> guesses = empty.get_bot()->get_best_guesses(1);
+	opening = guesses.empty() ? -1 : guesses[0].first * LOCKSTEP_COLS + guesses[0].second;
+
+	for (int k = 0; k < LOCKSTEP_LANES; k++) {
+		active[k] = false;
+		start_game(k);
+	}
+	bool any_active = games_started > 0;
+	while (any_active) {
+		if (counts_stale) {
+			update_counts();
+		}
+		flood();
+		for (int k = 0; k < LOCKSTEP_LANES; k++) { //Game lost if the opening was a mine, won if all safe squares revealed
+			if (active[k] && ((revealed.lo[k] & mines.lo[k]) | (revealed.hi[k] & mines.hi[k])) != 0) {
+				finish_game(k, false);
+			}
+			else if (active[k] && popcount64(revealed.lo[k]) + popcount64(revealed.hi[k]) == LOCKSTEP_SQUARES - m_mines) {
+				finish_game(k, true);
+			}
+		}
+		if (counts_stale) {
+			update_counts();
+		}
+		deduce();
+		any_active = false;
+		for (int k = 0; k < LOCKSTEP_LANES; k++) {
+			if (active[k] && !progress[k]) {
+				scalar_move(k);
+			}
+			any_active = any_active || active[k];
+		}
+		steps += 1;
+	}
+
+	elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+	return games_won;
+}
+
+//Start a new game in the lane with mines placed uniformly, keeping the first square free like a new terminal game
+//Leaves the lane empty once enough games have been started
+void LockstepSimulator::start_game(int lane) {
+	mines.lo[lane] = 0;
+	mines.hi[lane] = 0;
+	revealed.lo[lane] = 0;
+	revealed.hi[lane] = 0;
+	flagged.lo[lane] = 0;
+	flagged.hi[lane] = 0;
+	pending.lo[lane] = 0;
+	pending.hi[lane] = 0;
+	board_loaded[lane] = false;
+	counts_stale = true;
+	if (games_started >= games_target) {
+		active[lane] = false;
+		return;
+	}
+
+	string layout(LOCKSTEP_SQUARES, '0');
+	vector<int> candidates(LOCKSTEP_SQUARES - 1);
+	for (int p = 0; p < candidates.size(); p++) {
+		candidates[p] = p + 1;
+	}
+	for (int k = 0; k < m_mines; k++) { //Partial Fisher-Yates shuffle
+		uniform_int_distribution<int> dist(k, candidates.size() - 1);
+		swap(candidates[k], candidates[dist(rng)]);
+		int p = candidates[k];
+		layout[p] = '1';
+		if (p < 64) {
+			mines.lo[lane] |= 1ULL << p;
+		}
+		else {
+			mines.hi[lane] |= 1ULL << (p - 64);
+		}
+	}
+	if (opening >= 64) {
+		pending.hi[lane] |= 1ULL << (opening - 64);
+	}
+	else if (opening >= 0) {
+		pending.lo[lane] |= 1ULL << opening;
+	}
+	layouts[lane] = layout;
+	active[lane] = true;
+	games_started += 1;
+}
+
+//Record the result of the lane's game and start the next one
+void LockstepSimulator::finish_game(int lane, bool won) {
+	games_played += 1;
+	if (won) {
+		games_won += 1;
+	}
+	start_game(lane);
+}
+
+//Make one move in the lane with the scalar bot
+//The scalar board is first brought up to date by replaying the lane's reveals and flags since its last scalar move,
+//then the lane takes the board's reveals and flags, and the safe squares the bot has queued, back
+void LockstepSimulator::scalar_move(int lane) {
+	Board* b = boards[lane];
+	if (b == nullptr) {
+		b = new Board(LOCKSTEP_ROWS, LOCKSTEP_COLS, m_mines, Board::compress_seed(layouts[lane]), false);
+		b->get_bot()->set_edge_search_limit(MAX_SIZE);
+		b->get_bot()->set_move_time_budget(time_budget);
+		b->get_bot()->set_sample_budget(sample_budget);
+		boards[lane] = b;
+	}
+	else if (!board_loaded[lane]) {
+		b->load_seed(layouts[lane]);
+	}
+	board_loaded[lane] = true;
+
+	for (int p = 0; p < LOCKSTEP_SQUARES; p++) {
+		int i = p / LOCKSTEP_COLS;
+		int j = p % LOCKSTEP_COLS;
+		uint64_t bit = p < 64 ? (revealed.lo[lane] >> p) & 1 : (revealed.hi[lane] >> (p - 64)) & 1;
+		uint64_t flag = p < 64 ? (flagged.lo[lane] >> p) & 1 : (flagged.hi[lane] >> (p - 64)) & 1;
+		if (bit && !b->is_known(i, j)) {
+			b->make_move(i, j);
+		}
+		else if (flag && !b->is_marked_mine(i, j)) {
+			b->mark_mine(i, j);
+		}
+	}
+
+	Bot* bot = b->get_bot();
+	MoveResult res = bot->select_next_move();
+	scalar_moves += 1;
+	if (res == WIN || res == LOSS || res == GUESS_REQUIRED) {
+		finish_game(lane, res == WIN);
+		return;
+	}
+
+	for (int p = 0; p < LOCKSTEP_SQUARES; p++) {
+		int i = p / LOCKSTEP_COLS;
+		int j = p % LOCKSTEP_COLS;
+		uint64_t* rev = p < 64 ? &revealed.lo[lane] : &revealed.hi[lane];
+		uint64_t* flg = p < 64 ? &flagged.lo[lane] : &flagged.hi[lane];
+		uint64_t bit = 1ULL << (p < 64 ? p : p - 64);
+		if (b->is_safe(i, j)) {
+			*rev |= bit;
+		}
+		else if (b->is_marked_mine(i, j)) {
+			*flg |= bit;
+		}
+	}
+	for (pair<int, int> s : bot->get_safe_squares()) {
+		int p = s.first * LOCKSTEP_COLS + s.second;
+		if (p < 64) {
+			pending.lo[lane] |= 1ULL << p;
+		}
+		else {
+			pending.hi[lane] |= 1ULL << (p - 64);
+		}
+	}
+}
+
+//Compute the bit-sliced number of adjacent mines of every square in every lane
+void LockstepSimulator::update_counts() {
+	for (int k = 0; k < LOCKSTEP_LANES; k++) {
+		uint64_t sum_lo[LOCKSTEP_COUNT_BITS] = { 0 };
+		uint64_t sum_hi[LOCKSTEP_COUNT_BITS] = { 0 };
+		for_each_neighbour(mines.lo[k], mines.hi[k], [&](uint64_t n_lo, uint64_t n_hi) {
+			add_plane(sum_lo, sum_hi, n_lo, n_hi);
+		});
+		for (int b = 0; b < LOCKSTEP_COUNT_BITS; b++) {
+			counts[b].lo[k] = sum_lo[b];
+			counts[b].hi[k] = sum_hi[b];
+		}
+	}
+	counts_stale = false;
+}
+
+//Single-square search of every lane at once
+//Each revealed square compares its count with bit-sliced counts of its flagged and unknown neighbours:
+//if the count equals the flagged neighbours, its unknown neighbours are safe, and if it equals flagged plus unknown, they are mines
+void LockstepSimulator::deduce() {
+	for (int k = 0; k < LOCKSTEP_LANES; k++) {
+		if ((pending.lo[k] | pending.hi[k]) != 0) { //Game started since the last flood, its opening is revealed in the next step
+			progress[k] = true;
+			continue;
+		}
+		uint64_t unknown_lo = ~(revealed.lo[k] | flagged.lo[k]);
+		uint64_t unknown_hi = ~(revealed.hi[k] | flagged.hi[k]) & HI_MASK;
+		uint64_t flags_lo[LOCKSTEP_COUNT_BITS] = { 0 };
+		uint64_t flags_hi[LOCKSTEP_COUNT_BITS] = { 0 };
+		uint64_t open_lo[LOCKSTEP_COUNT_BITS] = { 0 };
+		uint64_t open_hi[LOCKSTEP_COUNT_BITS] = { 0 };
+		for_each_neighbour(flagged.lo[k], flagged.hi[k], [&](uint64_t n_lo, uint64_t n_hi) {
+			add_plane(flags_lo, flags_hi, n_lo, n_hi);
+		});
+		for_each_neighbour(unknown_lo, unknown_hi, [&](uint64_t n_lo, uint64_t n_hi) {
+			add_plane(open_lo, open_hi, n_lo, n_hi);
+		});
+
+		//Compare counts with flagged neighbours, and with flagged plus unknown neighbours (added with a ripple carry)
+		uint64_t all_known_lo = revealed.lo[k];
+		uint64_t all_known_hi = revealed.hi[k];
+		uint64_t all_mines_lo = revealed.lo[k];
+		uint64_t all_mines_hi = revealed.hi[k];
+		uint64_t carry_lo = 0;
+		uint64_t carry_hi = 0;
+		for (int b = 0; b < LOCKSTEP_COUNT_BITS; b++) {
+			uint64_t total_lo = flags_lo[b] ^ open_lo[b] ^ carry_lo;
+			uint64_t total_hi = flags_hi[b] ^ open_hi[b] ^ carry_hi;
+			carry_lo = (flags_lo[b] & open_lo[b]) | (carry_lo & (flags_lo[b] ^ open_lo[b]));
+			carry_hi = (flags_hi[b] & open_hi[b]) | (carry_hi & (flags_hi[b] ^ open_hi[b]));
+			all_known_lo &= ~(counts[b].lo[k] ^ flags_lo[b]);
+			all_known_hi &= ~(counts[b].hi[k] ^ flags_hi[b]);
+			all_mines_lo &= ~(counts[b].lo[k] ^ total_lo);
+			all_mines_hi &= ~(counts[b].hi[k] ^ total_hi);
+		}
+
+		uint64_t safe_lo, safe_hi, mine_lo, mine_hi;
+		dilate(all_known_lo, all_known_hi, safe_lo, safe_hi);
+		dilate(all_mines_lo, all_mines_hi, mine_lo, mine_hi);
+		safe_lo &= unknown_lo;
+		safe_hi &= unknown_hi;
+		mine_lo &= unknown_lo;
+		mine_hi &= unknown_hi;
+		pending.lo[k] |= safe_lo;
+		pending.hi[k] |= safe_hi;
+		flagged.lo[k] |= mine_lo;
+		flagged.hi[k] |= mine_hi;
+		progress[k] = (safe_lo | safe_hi | mine_lo | mine_hi) != 0;
+	}
+}
+
+//Reveal the pending safe squares of every lane, then keep revealing the neighbours of revealed squares with no adjacent mines
+//Steps all lanes together until none of them reveal anything more
+void LockstepSimulator::flood() {
+	for (int k = 0; k < LOCKSTEP_LANES; k++) {
+		revealed.lo[k] |= pending.lo[k];
+		revealed.hi[k] |= pending.hi[k];
+		pending.lo[k] = 0;
+		pending.hi[k] = 0;
+	}
+	bool changed = true;
+	while (changed) {
+		changed = false;
+		for (int k = 0; k < LOCKSTEP_LANES; k++) {
+			uint64_t zero_lo = revealed.lo[k];
+			uint64_t zero_hi = revealed.hi[k];
+			for (int b = 0; b < LOCKSTEP_COUNT_BITS; b++) {
+				zero_lo &= ~counts[b].lo[k];
+				zero_hi &= ~counts[b].hi[k];
+			}
+			uint64_t grow_lo, grow_hi;
+			dilate(zero_lo, zero_hi, grow_lo, grow_hi);
+			grow_lo &= ~revealed.lo[k];
+			grow_hi &= ~revealed.hi[k];
+			revealed.lo[k] |= grow_lo;
+			revealed.hi[k] |= grow_hi;
+			changed = changed || (grow_lo | grow_hi) != 0;
+		}
+	}
+}
+
+//Print out stats of the last simulation
+void LockstepSimulator::print_stats() {
+	cout << "Played " << games_played << " games in " << elapsed << " seconds (" << get_games_per_second() << " games/sec)" << endl;
+	cout << "Won: " << games_won << " (" << (games_played > 0 ? 100.0 * games_won / games_played : 0) << "%)" << endl;
+	cout << "Lockstep steps: " << steps << endl;
+	cout << "Scalar bot moves: " << scalar_moves << endl;
+}
+
+//Throughput of the last simulation
+double LockstepSimulator::get_games_per_second() {
+	if (elapsed <= 0) {
+		return 0;
+	}
+	return games_played / elapsed;
+}
@@ -0,0 +1,86 @@
+#ifndef LOCKSTEP_H
+#define LOCKSTEP_H
+
+#include <string>
+#include <vector>
+#include <random>
+#include <stdint.h>
+#include "util.h"
+
+#define LOCKSTEP_LANES 32 //Number of games advanced together
+#define LOCKSTEP_ROWS 9
+#define LOCKSTEP_COLS 9
+#define LOCKSTEP_SQUARES (LOCKSTEP_ROWS * LOCKSTEP_COLS) //81 squares, as two 64-bit words per plane
+#define LOCKSTEP_COUNT_BITS 4 //Bit-sliced counts of 0 to 8
+
+class Board;
+
+struct LanePlane { //One bit per square of each lane's board, split into the low 64 and high 17 squares
+	uint64_t lo[LOCKSTEP_LANES];
+	uint64_t hi[LOCKSTEP_LANES];
+};
+
+//Plays many 9x9 games at once with bitboards, one lane per game
+//Counts, flood reveals and single-square deductions are done for every lane together,
+//and only lanes that need an edge search or a guess fall back to the scalar bot for one move
+class LockstepSimulator {
+public:
+	//Initialization and cleanup
+	LockstepSimulator(int num_mines);
+	~LockstepSimulator();
+
+	//Set characteristics of the scalar bots
+	void set_edge_search_limit(int size);
+	void set_move_time_budget(double milliseconds);
+	void set_sample_budget(int samples);
+
+	//Key method: play the given number of games, returning the number won
+	int simulate(int num_games, unsigned seed);
+
+	//Stats of the last call to simulate
+	void print_stats();
+	double get_games_per_second();
+
+private:
+	//Lane management
+	void start_game(int lane);
+	void finish_game(int lane, bool won);
+	void scalar_move(int lane);
+
+	//Bitboard kernels run over all lanes
+	void update_counts();
+	void deduce();
+	void flood();
+
+	//Board setup values
+	int m_mines;
+	int MAX_SIZE;
+	double time_budget;
+	int sample_budget;
+
+	//Lane state
+	LanePlane mines;
+	LanePlane revealed;
+	LanePlane flagged;
+	LanePlane pending; //Squares proven safe and waiting to be revealed
+	LanePlane counts[LOCKSTEP_COUNT_BITS]; //Bit-sliced number of adjacent mines
+	bool active[LOCKSTEP_LANES];
+	bool progress[LOCKSTEP_LANES];
+	std::string layouts[LOCKSTEP_LANES];
+	Board* boards[LOCKSTEP_LANES]; //Scalar boards, replayed to the lane's reveals and flags when needed
+	bool board_loaded[LOCKSTEP_LANES];
+	bool counts_stale;
+	int opening; //Square the scalar bot opens every game with
+	int games_target;
+	std::mt19937 rng;
+
+	//Stats
+	int games_started;
+	int games_played;
+	int games_won;
+	long long steps;
+	long long scalar_moves;
+	double elapsed;
+};
+
+#endif //LOCKSTEP_H
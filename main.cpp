@@ -1,270 +1,739 @@
-﻿// minesweeper.cpp : Defines the entry point for the application.
-//
-
-#include <iostream>
-#include "board.h"
-#include "bot.h"
-#include "util.h"
-#include <string>
-#include <string.h>
-#include <ctype.h>
-#include <csignal>
-
-using namespace std;
-
-Action* act;
-Board* b;
-
-//Cleanup for Ctrl+C exit of program
-void signal_handler(int signum) {
-	cout << "Interrupt signal received, cleaning up" << endl;
-
-	if (act != nullptr) {
-		if (act->info != nullptr) {
-			delete act->info;
-		}
-		delete act;
-		if (b != nullptr) {
-			delete b;
-		}
-	}
-	cout << "Cleanup complete, exiting" << endl;
-	exit(0);
-}
-
-//Parse coordinates for manual move
-bool parse_coords(std::string in, Action* act) {
-	int count = 0;
-	std::string str_1("");
-	std::string str_2("");
-	for (int i = 0; i < in.length(); i++) {
-		if (!(isdigit(in[i]) || (count == 0 && in[i] == ' '))) {
-			return false;
-		}
-		if (count == 0) {
-			if (in[i] == ' ') {
-				count += 1;
-			}
-			else {
-				str_1 += in[i];
-			}
-		}
-		else {
-			str_2 += in[i];
-		}
-	}
-	act->type = USER_DEFINED_MOVE;
-	pair<int, int>* p = new pair<int, int>;
-	try {
-		p->first = stoi(str_1);
-		p->second = stoi(str_2);
-	}
-	catch (std::exception e) {
-		return false;
-	}
-	act->info = p;
-	return true;
-}
-
-//Parse integer for simulation
-int parse_int(std::string in) {
-	try {
-		int start_pos = in.find("simulate");
-		if (start_pos != in.length()) {
-			in.replace(start_pos, strlen("simulate"), "");
-		}
-		else {
-			in.replace(in.find('s'), strlen("simulate"), "");
-		}
-		cout << in << endl;
-		return stoi(in);
-	}
-	catch (std::exception e) {
-		cout << "Invalid input" << endl;
-		return -1;
-	}
-}
-
-//Convert user input into action
-bool parse_input(std::string in, Action* act) {
-	if (act->info != nullptr) {
-		delete act->info;
-		act->info = nullptr;
-	}
-	if (in.length() == 0) {
-		act->type = NEXT_MOVE;
-		act->info = nullptr;
-		return true;
-	}
-	if (parse_coords(in, act)) {
-		return true;
-	}
-	if (in == "n" || in == "next") {
-		act->type = NEXT_MOVE;
-		act->info = nullptr;
-		return true;
-	}
-	if (in == "r" || in == "reset") {
-		act->type = RESET;
-		act->info = nullptr;
-		return true;
-	}
-	if (in[0] == 's' || in.find("simulate") != 0) {
-		act->type = SIMULATE;
-		int* num = new int;
-		*num = parse_int(in);
-		if (*num == -1) {
-			delete num;
-			return false;
-		}
-		act->info = num;
-		return true;
-	}
-	if (in == "i" || in == "info") {
-		act->type = PRINT_COUNTS;
-		act->info = nullptr;
-		return true;
-	}
-	return false;
-}
-
-//Set value from string
-void set_value(char* arg, int &val) {
-	try {
-		std::string s = arg;
-		val = stoi(arg);
-	}
-	catch (const std::exception& e) {
-		cout << "Invalid argument" << endl;
-		exit(EINVAL);
-	}
-}
-
-//Main method
-int main(int argc, char** argv)
-{
-	signal(SIGINT, signal_handler); //Attach signal handler
-	
-	//Parse arguments
-	int rows=9;
-	int cols=9;
-	int mines=10;
-	int max_edge_size=10;
-	bool subset_approximation = true;
-	string seed;
-	Option curr_option = NO_OPT;
-	for (int i = 1; i < argc; i++) {		
-		if (curr_option != NO_OPT) {
-			if (curr_option == ROWS) {
-				set_value(argv[i], rows);
-			}
-			else if (curr_option == COLUMNS) {
-				set_value(argv[i], cols);
-			}
-			else if (curr_option == MINES) {
-				set_value(argv[i], mines);
-			}
-			else if (curr_option == MAX_EDGE_SIZE) {
-				set_value(argv[i], max_edge_size);
-			}
-			curr_option = NO_OPT;
-		}
-		else {
-			if (strcmp(argv[i], "-r") == 0 || strcmp(argv[i], "--rows") == 0) {
-				curr_option = ROWS;
-			}
-			else if (strcmp(argv[i], "-c") == 0 || strcmp(argv[i], "--columns") == 0) {
-				curr_option = COLUMNS;
-			}
-			else if (strcmp(argv[i], "-m") == 0 || strcmp(argv[i], "--mines") == 0) {
-				curr_option = MINES;
-			}
-			else if (strcmp(argv[i], "-e") == 0 || strcmp(argv[i], "--edge_size") == 0) {
-				curr_option = MAX_EDGE_SIZE;
-			}
-			else if (strcmp(argv[i], "-d") == 0 || strcmp(argv[i], "--disable_subset_approximations") == 0) {
-				subset_approximation = false;
-			}
-			else if (strcmp(argv[i],"-h") == 0 || strcmp(argv[i], "--help") == 0) {
-				cout << "Start the minesweeper solver." << endl;
-				cout << "Options:" << endl;
-				cout << "	--rows (-r) [int]: Set the number of rows" << endl;
-				cout << "	--cols (-m) [int]: Set the number of columns" << endl;
-				cout << "	--mines (-e) [int]: Set the number of mines" << endl;
-				cout << "	--edge_size (-s) [int]: Set the maximum number of squares searched without approximation" << endl;
-				cout << "	--disable_subset_approximations (-d): Disable subset approximation for large edges" << endl;
-				cout << "Commands:" << endl;
-				cout << "\tnext (n, enter): Play the next best move" << endl;
-				cout << "\treset (r): Start a new game" << endl;
-				cout << "\tquit (q): Close the program" << endl;
-				cout << "\tinfo (i): View relevant stats" << endl;
-				cout << "\tsimulate [int] (s): Simulate several games in order" << endl;
-				cout << "\t[int] [int]: Make a move manually at the specified square" << endl;
-				return 0;
-			}
-			else if (strchr(argv[i], 'x') != NULL || strchr(argv[i], 'X') != NULL) {
-				int j = 0;
-				while (argv[i][j] != 'x' && argv[i][j] != 'X') {
-					j++;
-				}
-				try {
-					std::string arg = argv[i];
-					rows = stoi(arg.substr(0, j));
-					cols = stoi(arg.substr(j + 1, arg.length()-j));
-				}
-				catch (const std::exception& e) {
-					cout << "Invalid row and column value" << endl;
-					return EINVAL;
-				}
-			}
-			else {
-				cout << "Invalid argument " << argv[i] << endl;
-				cout << "Run with -h flag for help" << endl;
-				return EINVAL;
-			}
-		}
-	}
-
-	//Initialize board
-	if (subset_approximation) {
-		cout << "Initializing board with " << rows << " rows, " << cols << " columns, " << mines << " mines, maximum edge size of " << max_edge_size << " and subset approximation enabled" << endl;
-	}
-	else {
-		cout << "Initializing board with " << rows << " rows, " << cols << " columns, " << mines << " mines, maximum edge size of " << max_edge_size<< " and subset approximation disabled" << endl;
-	}
-	
-	if (seed.length() > 0) {
-		b = new Board(rows, cols, mines, seed);
-	}
-	else {
-		b = new Board(rows, cols, mines);
-	}
-	b->get_bot()->set_edge_search_limit(max_edge_size);
-	b->get_bot()->set_edge_subset_approximation(subset_approximation);
-		
-	//Main gameplay loop
-	std::string user_in;
-	act = new Action;
-	act->info = nullptr;
-	b->print_board();
-	while (user_in != "quit" && user_in != "q") {
-		getline(cin, user_in);
-		if (parse_input(user_in, act)) {
-			if (b->handle_action(act)) {
-				b->print_board();
-			}
-		}
-		else {
-			cout << "Invalid input, try inputting \"help\" for help" << endl;
-		}
-	}
-
-	//Cleanup
-	if (act->info != nullptr) {
-		delete act->info;
-	}
-	delete act;
-	delete b;
-	cout << "Cleanup done" << endl;
-	return 0;
-}
+﻿// minesweeper.cpp : Defines the entry point for the application.
+//
+
+#include <iostream>
+#include "board.h"
+#include "bot.h"
+#include "util.h"
+#include "server.h"
+#include "tiled_board.h"
+#include "seed_runner.h"
+#include "shard_runner.h"
+#include "solver.h"
+#include <string>
+#include <string.h>
+#include <ctype.h>
+#include <csignal>
+#include <cstdlib>
+#include <algorithm>
+
+using namespace std;
+
+Action* act;
+Board* b;
+SolutionCache* cache;
+string cache_path;
+CostModel* cost_model;
+string cost_model_path;
+RecordWriter* records;
+volatile sig_atomic_t interrupted = 0;
+
+//Save and free pattern cache
+void cleanup_cache() {
+	if (cache != nullptr) {
+		if (!cache->save(cache_path)) {
+			cout << "Could not save pattern cache to " << cache_path << endl;
+		}
+		delete cache;
+		cache = nullptr;
+	}
+}
+
+//Save and free cost model
+void cleanup_cost_model() {
+	if (cost_model != nullptr) {
+		if (cost_model_path.length() > 0 && !cost_model->save(cost_model_path)) {
+			cout << "Could not save cost model to " << cost_model_path << endl;
+		}
+		delete cost_model;
+		cost_model = nullptr;
+	}
+}
+
+//Close and free record writer
+void cleanup_records() {
+	if (records != nullptr) {
+		records->close();
+		delete records;
+		records = nullptr;
+	}
+}
+
+//Ctrl+C handler: only sets a flag, since saving and freeing are not safe in a signal handler, and the main loop then cleans up and exits
+//A second Ctrl+C exits at once, for commands still running after the first
+void signal_handler(int signum) {
+	if (interrupted) {
+		_Exit(EINTR);
+	}
+	interrupted = 1;
+}
+
+//Parse coordinates for manual move
+bool parse_coords(std::string in, Action* act) {
+	int count = 0;
+	std::string str_1("");
+	std::string str_2("");
+	for (int i = 0; i < in.length(); i++) {
+		if (!(isdigit(in[i]) || (count == 0 && in[i] == ' '))) {
+			return false;
+		}
+		if (count == 0) {
+			if (in[i] == ' ') {
+				count += 1;
+			}
+			else {
+				str_1 += in[i];
+			}
+		}
+		else {
+			str_2 += in[i];
+		}
+	}
+	act->type = USER_DEFINED_MOVE;
+	pair<int, int>* p = new pair<int, int>;
+	try {
+		p->first = stoi(str_1);
+		p->second = stoi(str_2);
+	}
+	catch (std::exception e) {
+		return false;
+	}
+	act->info = p;
+	return true;
+}
+
+//Parse integer argument of a command (given as full word or first letter)
+int parse_int(std::string in, std::string command) {
+	try {
+		if (in.find(command) == 0) {
+			in.replace(0, command.length(), "");
+		}
+		else {
+			in.replace(0, 1, "");
+		}
+		cout << in << endl;
+		return stoi(in);
+	}
+	catch (std::exception e) {
+		cout << "Invalid input" << endl;
+		return -1;
+	}
+}
+
+//Convert user input into action
+bool parse_input(std::string in, Action* act) {
+	if (act->info != nullptr) {
+		delete act->info;
+		act->info = nullptr;
+	}
+	if (in.length() == 0) {
+		act->type = NEXT_MOVE;
+		act->info = nullptr;
+		return true;
+	}
+	if (parse_coords(in, act)) {
+		return true;
+	}
+	if (in == "n" || in == "next") {
+		act->type = NEXT_MOVE;
+		act->info = nullptr;
+		return true;
+	}
+	if (in == "r" || in == "reset") {
+		act->type = RESET;
+		act->info = nullptr;
+		return true;
+	}
+	if (in[0] == 'g' || in.find("generate") == 0) {
+		act->type = GENERATE;
+		int* num = new int;
+		*num = parse_int(in, "generate");
+		if (*num == -1) {
+			delete num;
+			return false;
+		}
+		act->info = num;
+		return true;
+	}
+	if (in[0] == 's' || in.find("simulate") == 0) {
+		act->type = SIMULATE;
+		int* num = new int;
+		*num = parse_int(in, "simulate");
+		if (*num == -1) {
+			delete num;
+			return false;
+		}
+		act->info = num;
+		return true;
+	}
+	if (in[0] == 'b' || in.find("batch") == 0) {
+		act->type = LOCKSTEP_SIMULATE;
+		int* num = new int;
+		*num = parse_int(in, "batch");
+		if (*num == -1) {
+			delete num;
+			return false;
+		}
+		act->info = num;
+		return true;
+	}
+	if (in[0] == 'a' || in.find("autotune") == 0) {
+		act->type = AUTOTUNE;
+		int* num = new int;
+		*num = parse_int(in, "autotune");
+		if (*num == -1) {
+			delete num;
+			return false;
+		}
+		act->info = num;
+		return true;
+	}
+	if (in == "i" || in == "info") {
+		act->type = PRINT_COUNTS;
+		act->info = nullptr;
+		return true;
+	}
+	return false;
+}
+
+//Copy the board's known squares into a view for the solver, with every unknown square as UNREVEALED_SAFE so nothing hidden is given away
+SolverView view_board(Board* board, vector<State>* states, vector<int>* counts) {
+	int rows = board->get_rows();
+	int cols = board->get_cols();
+	states->assign(rows * cols, UNREVEALED_SAFE);
+	counts->assign(rows * cols, 0);
+	for (int i = 0; i < rows; i++) {
+		for (int j = 0; j < cols; j++) {
+			if (board->is_safe(i, j)) {
+				(*states)[i * cols + j] = KNOWN_SAFE;
+				(*counts)[i * cols + j] = board->get_count(i, j);
+			}
+			else if (board->is_marked_mine(i, j)) {
+				(*states)[i * cols + j] = KNOWN_MINE;
+			}
+		}
+	}
+	SolverView view;
+	view.rows = rows;
+	view.cols = cols;
+	view.mines = board->get_mines();
+	view.states = states->data();
+	view.counts = counts->data();
+	return view;
+}
+
+//Play the next move of the game with the solver: flag the mines it proves, then reveal a square it proves safe, or otherwise guess its safest square
+//Returns false if the game is already over
+bool solver_move(Board* board, Solver* solver) {
+	if (!board->is_active()) {
+		return false;
+	}
+	vector<State> states;
+	vector<int> counts;
+	SolverView view = view_board(board, &states, &counts);
+	SolverResult result = solver->solve(view);
+	for (pair<int, int> p : result.mines) {
+		board->mark_mine(p.first, p.second);
+	}
+	if (!result.safe_squares.empty()) {
+		pair<int, int> p = result.safe_squares[0];
+		board->make_move(p.first, p.second);
+	}
+	else if (result.best_guess.first >= 0) {
+		pair<int, int> p = result.best_guess;
+		cout << "Guessing " << p.first << "," << p.second << " (" << (1 - result.probabilities[p.first * view.cols + p.second]) * 100 << "% safe)" << endl;
+		board->make_move(p.first, p.second);
+	}
+	return true;
+}
+
+//Set value from string
+void set_value(char* arg, int &val) {
+	try {
+		std::string s = arg;
+		val = stoi(arg);
+	}
+	catch (const std::exception& e) {
+		cout << "Invalid argument" << endl;
+		exit(EINVAL);
+	}
+}
+
+//Main method
+int main(int argc, char** argv)
+{
+	//Attach signal handler, without restarting reads so that waiting for the next command stops at Ctrl+C
+#ifdef _WIN32
+	signal(SIGINT, signal_handler);
+#else
+	struct sigaction action = {};
+	action.sa_handler = signal_handler;
+	sigemptyset(&action.sa_mask);
+	action.sa_flags = 0;
+	sigaction(SIGINT, &action, nullptr);
+#endif
+	
+	//Parse arguments
+	int rows=9;
+	int cols=9;
+	int mines=10;
+	int max_edge_size=10;
+	int time_budget=0;
+	int sample_budget=0;
+	bool subset_approximation = true;
+	bool edge_reduction = false;
+	bool model_counting = false;
+	int endgame_squares = 0;
+	int endgame_mines = 16;
+	int lookahead = 0;
+	int lookahead_time = 20;
+	bool server = false;
+	int tiled_moves = 0;
+	int search_threads = 1;
+	int node_budget = SECTIONED_NODE_BUDGET;
+	int memory_budget = SECTIONED_MEMORY_BUDGET;
+	int move_target = 0;
+	string seed;
+	string seed_file;
+	string records_path;
+	int shards = 0;
+	int games = 1000;
+	int run_seed = 0;
+	bool run_seed_set = false;
+	string shard_stats = "shard_stats";
+	Option curr_option = NO_OPT;
+	for (int i = 1; i < argc; i++) {		
+		if (curr_option != NO_OPT) {
+			if (curr_option == ROWS) {
+				set_value(argv[i], rows);
+			}
+			else if (curr_option == COLUMNS) {
+				set_value(argv[i], cols);
+			}
+			else if (curr_option == MINES) {
+				set_value(argv[i], mines);
+			}
+			else if (curr_option == MAX_EDGE_SIZE) {
+				set_value(argv[i], max_edge_size);
+			}
+			else if (curr_option == TIME_BUDGET) {
+				set_value(argv[i], time_budget);
+			}
+			else if (curr_option == SAMPLE_BUDGET) {
+				set_value(argv[i], sample_budget);
+			}
+			else if (curr_option == PATTERN_CACHE) {
+				cache_path = argv[i];
+			}
+			else if (curr_option == ENDGAME_SQUARES) {
+				set_value(argv[i], endgame_squares);
+			}
+			else if (curr_option == ENDGAME_MINES) {
+				set_value(argv[i], endgame_mines);
+			}
+			else if (curr_option == LOOKAHEAD) {
+				set_value(argv[i], lookahead);
+			}
+			else if (curr_option == LOOKAHEAD_TIME) {
+				set_value(argv[i], lookahead_time);
+			}
+			else if (curr_option == TILED_MOVES) {
+				set_value(argv[i], tiled_moves);
+			}
+			else if (curr_option == SEARCH_THREADS) {
+				set_value(argv[i], search_threads);
+			}
+			else if (curr_option == NODE_BUDGET) {
+				set_value(argv[i], node_budget);
+			}
+			else if (curr_option == MEMORY_BUDGET) {
+				set_value(argv[i], memory_budget);
+			}
+			else if (curr_option == COST_MODEL) {
+				cost_model_path = argv[i];
+			}
+			else if (curr_option == MOVE_TARGET) {
+				set_value(argv[i], move_target);
+			}
+			else if (curr_option == SEED) {
+				seed = argv[i];
+			}
+			else if (curr_option == SEED_FILE) {
+				seed_file = argv[i];
+			}
+			else if (curr_option == RECORDS) {
+				records_path = argv[i];
+			}
+			else if (curr_option == SHARDS) {
+				set_value(argv[i], shards);
+			}
+			else if (curr_option == GAMES) {
+				set_value(argv[i], games);
+			}
+			else if (curr_option == RUN_SEED) {
+				set_value(argv[i], run_seed);
+				run_seed_set = true;
+			}
+			else if (curr_option == SHARD_STATS) {
+				shard_stats = argv[i];
+			}
+			curr_option = NO_OPT;
+		}
+		else {
+			if (strcmp(argv[i], "-r") == 0 || strcmp(argv[i], "--rows") == 0) {
+				curr_option = ROWS;
+			}
+			else if (strcmp(argv[i], "-c") == 0 || strcmp(argv[i], "--columns") == 0) {
+				curr_option = COLUMNS;
+			}
+			else if (strcmp(argv[i], "-m") == 0 || strcmp(argv[i], "--mines") == 0) {
+				curr_option = MINES;
+			}
+			else if (strcmp(argv[i], "-e") == 0 || strcmp(argv[i], "--edge_size") == 0) {
+				curr_option = MAX_EDGE_SIZE;
+			}
+			else if (strcmp(argv[i], "-t") == 0 || strcmp(argv[i], "--time_budget") == 0) {
+				curr_option = TIME_BUDGET;
+			}
+			else if (strcmp(argv[i], "-p") == 0 || strcmp(argv[i], "--sample_budget") == 0) {
+				curr_option = SAMPLE_BUDGET;
+			}
+			else if (strcmp(argv[i], "-k") == 0 || strcmp(argv[i], "--pattern_cache") == 0) {
+				curr_option = PATTERN_CACHE;
+			}
+			else if (strcmp(argv[i], "-u") == 0 || strcmp(argv[i], "--endgame_squares") == 0) {
+				curr_option = ENDGAME_SQUARES;
+			}
+			else if (strcmp(argv[i], "-n") == 0 || strcmp(argv[i], "--endgame_mines") == 0) {
+				curr_option = ENDGAME_MINES;
+			}
+			else if (strcmp(argv[i], "-a") == 0 || strcmp(argv[i], "--lookahead") == 0) {
+				curr_option = LOOKAHEAD;
+			}
+			else if (strcmp(argv[i], "-b") == 0 || strcmp(argv[i], "--lookahead_time") == 0) {
+				curr_option = LOOKAHEAD_TIME;
+			}
+			else if (strcmp(argv[i], "-d") == 0 || strcmp(argv[i], "--disable_subset_approximations") == 0) {
+				subset_approximation = false;
+			}
+			else if (strcmp(argv[i], "-l") == 0 || strcmp(argv[i], "--linear_reduction") == 0) {
+				edge_reduction = true;
+			}
+			else if (strcmp(argv[i], "-x") == 0 || strcmp(argv[i], "--model_counting") == 0) {
+				model_counting = true;
+			}
+			else if (strcmp(argv[i], "-w") == 0 || strcmp(argv[i], "--server") == 0) {
+				server = true;
+			}
+			else if (strcmp(argv[i], "-z") == 0 || strcmp(argv[i], "--tiled") == 0) {
+				curr_option = TILED_MOVES;
+			}
+			else if (strcmp(argv[i], "-j") == 0 || strcmp(argv[i], "--search_threads") == 0) {
+				curr_option = SEARCH_THREADS;
+			}
+			else if (strcmp(argv[i], "-o") == 0 || strcmp(argv[i], "--node_budget") == 0) {
+				curr_option = NODE_BUDGET;
+			}
+			else if (strcmp(argv[i], "-y") == 0 || strcmp(argv[i], "--memory_budget") == 0) {
+				curr_option = MEMORY_BUDGET;
+			}
+			else if (strcmp(argv[i], "-f") == 0 || strcmp(argv[i], "--cost_model") == 0) {
+				curr_option = COST_MODEL;
+			}
+			else if (strcmp(argv[i], "-q") == 0 || strcmp(argv[i], "--target_time") == 0) {
+				curr_option = MOVE_TARGET;
+			}
+			else if (strcmp(argv[i], "-s") == 0 || strcmp(argv[i], "--seed") == 0) {
+				curr_option = SEED;
+			}
+			else if (strcmp(argv[i], "-i") == 0 || strcmp(argv[i], "--seed_file") == 0) {
+				curr_option = SEED_FILE;
+			}
+			else if (strcmp(argv[i], "-g") == 0 || strcmp(argv[i], "--records") == 0) {
+				curr_option = RECORDS;
+			}
+			else if (strcmp(argv[i], "-F") == 0 || strcmp(argv[i], "--shards") == 0) {
+				curr_option = SHARDS;
+			}
+			else if (strcmp(argv[i], "-N") == 0 || strcmp(argv[i], "--games") == 0) {
+				curr_option = GAMES;
+			}
+			else if (strcmp(argv[i], "-S") == 0 || strcmp(argv[i], "--run_seed") == 0) {
+				curr_option = RUN_SEED;
+			}
+			else if (strcmp(argv[i], "-P") == 0 || strcmp(argv[i], "--shard_stats") == 0) {
+				curr_option = SHARD_STATS;
+			}
+			else if (strcmp(argv[i],"-h") == 0 || strcmp(argv[i], "--help") == 0) {
+				cout << "Start the minesweeper solver." << endl;
+				cout << "Options:" << endl;
+				cout << "	--rows (-r) [int]: Set the number of rows" << endl;
+				cout << "	--columns (-c) [int]: Set the number of columns" << endl;
+				cout << "	--mines (-m) [int]: Set the number of mines" << endl;
+				cout << "	--edge_size (-e) [int]: Set the maximum number of squares searched without approximation" << endl;
+				cout << "	--disable_subset_approximations (-d): Disable subset approximation for large edges" << endl;
+				cout << "	--linear_reduction (-l): Reduce edge constraints by Gaussian elimination, searching only the remaining free squares" << endl;
+				cout << "	--model_counting (-x): Count possibilities of large edges exactly, splitting them into independent components" << endl;
+				cout << "	--time_budget (-t) [int]: Set the maximum search time per move in milliseconds (0 for no limit)" << endl;
+				cout << "	--sample_budget (-p) [int]: Sample large edges with the given number of samples instead of subset approximation (0 to disable)" << endl;
+				cout << "	--pattern_cache (-k) [file]: Cache edge search results across games, loading from and saving to the given file" << endl;
+				cout << "	--endgame_squares (-u) [int]: Solve the whole board exactly once at most this many squares are unknown (0 to disable)" << endl;
+				cout << "	--endgame_mines (-n) [int]: Only solve the whole board exactly once at most this many mines are left (default 16)" << endl;
+				cout << "	--lookahead (-a) [int]: Compare this many of the best guesses by their chance of making progress (0 to disable)" << endl;
+				cout << "	--lookahead_time (-b) [int]: Set the maximum time spent comparing guesses in milliseconds (default 20)" << endl;
+				cout << "	--server (-w): Host many games over a line-delimited protocol on stdin/stdout instead of a single game" << endl;
+				cout << "	--tiled (-z) [int]: Let the bot play up to this many moves of one game on a board generated a tile at a time as it is explored, for boards too large to store" << endl;
+				cout << "	--search_threads (-j) [int]: Search independent edges and sub-edges on this many threads at once (default 1)" << endl;
+				cout << "	--node_budget (-o) [int]: Set the maximum number of nodes of each sub-edge tree before falling back to greedy sub-edges (default " << SECTIONED_NODE_BUDGET << ", 0 for no limit)" << endl;
+				cout << "	--memory_budget (-y) [int]: Set the maximum memory of the sub-edge trees built at once in megabytes (default " << SECTIONED_MEMORY_BUDGET << ", 0 for no limit)" << endl;
+				cout << "	--cost_model (-f) [file]: Time precise edge searches to fit a model of their cost, loading from and saving to the given file" << endl;
+				cout << "	--target_time (-q) [int]: Choose between precise and approximate search of each edge with the cost model, aiming for this many milliseconds per move instead of a fixed edge size (0 to disable)" << endl;
+				cout << "	--seed (-s) [seed]: Start the game from the given compressed seed, as printed at the start of each game" << endl;
+				cout << "	--seed_file (-i) [file]: Play every seed of the file (one compressed seed per line) on several threads, printing one result per seed in order instead of a single game" << endl;
+				cout << "	--records (-g) [file]: Write a binary record of each simulated or replayed game to the given file, summarised by minesweeper_records" << endl;
+				cout << "	--shards (-F) [int]: Simulate games in this many forked processes instead of a single game, merging their stats (0 to disable)" << endl;
+				cout << "	--games (-N) [int]: Set the number of games simulated by --shards (default 1000)" << endl;
+				cout << "	--run_seed (-S) [int]: Set the seed the layout of every game simulated by --shards is generated from (default 0), or the seed of the --tiled board (default the current time)" << endl;
+				cout << "	--shard_stats (-P) [prefix]: Write the stats of each shard to [prefix].[shard], continuing any shard of the same run already there (default shard_stats)" << endl;
+				cout << "Commands:" << endl;
+				cout << "\tnext (n, enter): Play the next best move" << endl;
+				cout << "\treset (r): Start a new game" << endl;
+				cout << "\tquit (q): Close the program" << endl;
+				cout << "\tinfo (i): View relevant stats" << endl;
+				cout << "\tsimulate [int] (s): Simulate several games in order" << endl;
+				cout << "\tgenerate [int] (g): Generate boards solvable without guessing" << endl;
+				cout << "\tbatch [int] (b): Simulate several 9x9 games at once with bitboards" << endl;
+				cout << "\tautotune [int] (a): Fit the cost model by simulating this many games at each of a sweep of edge sizes" << endl;
+				cout << "\t[int] [int]: Make a move manually at the specified square" << endl;
+				cout << "Server requests (each line starts with a tag repeated in its response):" << endl;
+				cout << "\t[tag] new [int] [int] [int]: Open a game with the given rows, columns and mines, responding with its id" << endl;
+				cout << "\t[tag] next [id]: Let the bot play the next move of the game" << endl;
+				cout << "\t[tag] hint [id]: Suggest a safe square, or the best guess with its probability" << endl;
+				cout << "\t[tag] move [id] [int] [int]: Make a move at the specified square" << endl;
+				cout << "\t[tag] reset [id]: Start a new game of the same size" << endl;
+				cout << "\t[tag] close [id]: Close the game" << endl;
+				cout << "\t[tag] stats: View open games and latency of each request type in microseconds" << endl;
+				return 0;
+			}
+			else if (strchr(argv[i], 'x') != NULL || strchr(argv[i], 'X') != NULL) {
+				int j = 0;
+				while (argv[i][j] != 'x' && argv[i][j] != 'X') {
+					j++;
+				}
+				try {
+					std::string arg = argv[i];
+					rows = stoi(arg.substr(0, j));
+					cols = stoi(arg.substr(j + 1, arg.length()-j));
+				}
+				catch (const std::exception& e) {
+					cout << "Invalid row and column value" << endl;
+					return EINVAL;
+				}
+			}
+			else {
+				cout << "Invalid argument " << argv[i] << endl;
+				cout << "Run with -h flag for help" << endl;
+				return EINVAL;
+			}
+		}
+	}
+
+	//Cost model shared by every bot, fitted further as they play
+	if (cost_model_path.length() > 0 || move_target > 0) {
+		cost_model = new CostModel();
+		if (cost_model_path.length() > 0 && cost_model->load(cost_model_path)) {
+			cout << "Loaded cost model from " << cost_model_path << endl;
+		}
+	}
+
+	//Serve many games instead of playing one
+	if (server) {
+		GameServer game_server(NUM_THREADS);
+		game_server.set_edge_search_limit(max_edge_size);
+		game_server.set_edge_subset_approximation(subset_approximation);
+		game_server.set_edge_reduction(edge_reduction);
+		game_server.set_model_counting(model_counting);
+		game_server.set_endgame_thresholds(endgame_squares, endgame_mines);
+		game_server.set_lookahead(lookahead, lookahead_time);
+		game_server.set_move_time_budget(time_budget);
+		game_server.set_sample_budget(sample_budget);
+		game_server.set_sectioned_budget(node_budget, memory_budget);
+		game_server.set_cost_model(cost_model, move_target);
+		game_server.run(cin, cout);
+		cleanup_cost_model();
+		return 0;
+	}
+
+	//Records of simulated games
+	if (records_path.length() > 0) {
+		records = new RecordWriter();
+		if (!records->open(records_path)) {
+			cout << "Could not create record file " << records_path << endl;
+			cleanup_records();
+			cleanup_cost_model();
+			return ENOENT;
+		}
+	}
+
+	//Replay a file of seeds instead of playing one game
+	if (seed_file.length() > 0) {
+		SeedRunner runner(rows, cols, mines, NUM_THREADS);
+		runner.set_edge_search_limit(max_edge_size);
+		runner.set_edge_subset_approximation(subset_approximation);
+		runner.set_edge_reduction(edge_reduction);
+		runner.set_model_counting(model_counting);
+		runner.set_endgame_thresholds(endgame_squares, endgame_mines);
+		runner.set_lookahead(lookahead, lookahead_time);
+		runner.set_move_time_budget(time_budget);
+		runner.set_sample_budget(sample_budget);
+		runner.set_sectioned_budget(node_budget, memory_budget);
+		runner.set_cost_model(cost_model, move_target);
+		runner.set_record_writer(records);
+		if (!runner.run(seed_file, cout)) {
+			cout << "Could not read seed file " << seed_file << endl;
+			cleanup_cost_model();
+			cleanup_records();
+			return ENOENT;
+		}
+		runner.print_stats();
+		cleanup_cost_model();
+		cleanup_records();
+		return 0;
+	}
+
+	//Play one game on a huge board, generated only where it is explored
+	if (tiled_moves > 0) {
+		unsigned long long tiled_seed = run_seed_set ? (unsigned long long)run_seed : (unsigned long long)time(NULL); //Replay a game with --run_seed
+		cout << "Playing on tiled board with " << rows << " rows, " << cols << " columns and " << mines << " mines (seed " << tiled_seed << ")" << endl;
+		TiledBoard tiled_board(rows, cols, mines, tiled_seed);
+		tiled_board.get_bot()->set_edge_search_limit(max_edge_size);
+		tiled_board.get_bot()->set_edge_subset_approximation(subset_approximation);
+		tiled_board.get_bot()->set_edge_reduction(edge_reduction);
+		tiled_board.get_bot()->set_model_counting(model_counting);
+		tiled_board.get_bot()->set_endgame_thresholds(endgame_squares, endgame_mines);
+		tiled_board.get_bot()->set_lookahead(lookahead, lookahead_time);
+		tiled_board.get_bot()->set_move_time_budget(time_budget);
+		tiled_board.get_bot()->set_sample_budget(sample_budget);
+		tiled_board.get_bot()->set_search_threads(search_threads);
+		tiled_board.get_bot()->set_sectioned_budget(node_budget, memory_budget);
+		tiled_board.get_bot()->set_cost_model(cost_model, move_target);
+		MoveResult res = CONTINUE;
+		for (int k = 0; k < tiled_moves && res == CONTINUE; k++) {
+			res = tiled_board.next_move();
+		}
+		cout << (res == WIN ? "Game won" : res == LOSS ? "Game lost" : "Move limit reached") << endl;
+		tiled_board.print_stats();
+		cleanup_cost_model();
+		cleanup_records();
+		return 0;
+	}
+
+	//Initialize board
+	if (subset_approximation) {
+		cout << "Initializing board with " << rows << " rows, " << cols << " columns, " << mines << " mines, maximum edge size of " << max_edge_size << " and subset approximation enabled" << endl;
+	}
+	else {
+		cout << "Initializing board with " << rows << " rows, " << cols << " columns, " << mines << " mines, maximum edge size of " << max_edge_size<< " and subset approximation disabled" << endl;
+	}
+	
+	if (seed.length() > 0) {
+		string layout = Board::decompress_seed(seed);
+		if (layout.length() != rows * cols || count(layout.begin(), layout.end(), '1') != mines) {
+			cout << "Seed does not match a board with " << rows << " rows, " << cols << " columns and " << mines << " mines" << endl;
+			cleanup_cost_model();
+			cleanup_records();
+			return EINVAL;
+		}
+		b = new Board(rows, cols, mines, seed);
+	}
+	else {
+		b = new Board(rows, cols, mines);
+	}
+	b->get_bot()->set_edge_search_limit(max_edge_size);
+	b->get_bot()->set_edge_subset_approximation(subset_approximation);
+	b->get_bot()->set_edge_reduction(edge_reduction);
+	b->get_bot()->set_model_counting(model_counting);
+	b->get_bot()->set_endgame_thresholds(endgame_squares, endgame_mines);
+	b->get_bot()->set_lookahead(lookahead, lookahead_time);
+	b->get_bot()->set_move_time_budget(time_budget);
+	b->get_bot()->set_sample_budget(sample_budget);
+	b->get_bot()->set_search_threads(shards > 0 ? 1 : search_threads); //Search threads do not survive fork
+	b->get_bot()->set_sectioned_budget(node_budget, memory_budget);
+	b->get_bot()->set_cost_model(cost_model, move_target);
+	b->set_record_writer(records);
+	if (cache_path.length() > 0) {
+		cache = new SolutionCache(PATTERN_CACHE_SIZE);
+		if (cache->load(cache_path)) {
+			cout << "Loaded pattern cache from " << cache_path << endl;
+		}
+		b->get_bot()->set_solution_cache(cache);
+	}
+
+	//Simulate games in several processes instead of playing one
+	if (shards > 0) {
+		if (records != nullptr) {
+			cout << "Game records are not written by sharded simulation" << endl;
+		}
+		ShardRunner runner(shards, games, (unsigned)run_seed, shard_stats);
+		bool ok = runner.run(b);
+		runner.print_stats();
+		delete b;
+		cleanup_cache();
+		cleanup_cost_model();
+		cleanup_records();
+		return ok ? 0 : EIO;
+	}
+		
+	//The REPL's moves are played through the solver library, with the same settings as the board's bot (which the other commands use)
+	Solver solver;
+	solver.get_bot()->set_edge_search_limit(max_edge_size);
+	solver.get_bot()->set_edge_subset_approximation(subset_approximation);
+	solver.get_bot()->set_edge_reduction(edge_reduction);
+	solver.get_bot()->set_model_counting(model_counting);
+	solver.get_bot()->set_endgame_thresholds(endgame_squares, endgame_mines);
+	solver.get_bot()->set_move_time_budget(time_budget);
+	solver.get_bot()->set_sample_budget(sample_budget);
+	solver.get_bot()->set_search_threads(search_threads);
+	solver.get_bot()->set_sectioned_budget(node_budget, memory_budget);
+	solver.get_bot()->set_cost_model(cost_model, move_target);
+	solver.get_bot()->set_solution_cache(cache);
+
+	//Main gameplay loop
+	std::string user_in;
+	act = new Action;
+	act->info = nullptr;
+	b->print_board();
+	while (user_in != "quit" && user_in != "q") {
+		if (!getline(cin, user_in) || interrupted) {
+			if (interrupted) {
+				cout << "Interrupt signal received, cleaning up" << endl;
+			}
+			break;
+		}
+		if (parse_input(user_in, act)) {
+			if (act->type == NEXT_MOVE) {
+				if (solver_move(b, &solver)) {
+					b->print_board();
+				}
+			}
+			else if (b->handle_action(act)) {
+				b->print_board();
+			}
+		}
+		else {
+			cout << "Invalid input, try inputting \"help\" for help" << endl;
+		}
+	}
+
+	//Cleanup
+	if (act->info != nullptr) {
+		delete act->info;
+	}
+	delete act;
+	delete b;
+	cleanup_cache();
+	cleanup_cost_model();
+	cleanup_records();
+	cout << "Cleanup done" << endl;
+	return 0;
+}
@@ -0,0 +1,312 @@
+#include "model_counter.h"
+#include <algorithm>
+
+using namespace std;
+
+//Constructor for default values
+ModelCounter::ModelCounter() {
+	use_deadline = false;
+	aborted = false;
+	nodes = 0;
+	cache_hits = 0;
+	max_components = 0;
+}
+
+//Set deadline for counting (ignored when not enabled)
+void ModelCounter::set_deadline(chrono::steady_clock::time_point time, bool enabled) {
+	deadline = time;
+	use_deadline = enabled;
+}
+
+int ModelCounter::get_nodes() {
+	return nodes;
+}
+
+int ModelCounter::get_cache_hits() {
+	return cache_hits;
+}
+
+int ModelCounter::get_max_components() {
+	return max_components;
+}
+
+//Count possibilities of squares 0 to num_squares - 1 satisfying every constraint
+//Fills the number of possibilities with each square as a mine and with each number of mines
+bool ModelCounter::count(int num_squares, vector<CountConstraint>* constraints, vector<double>* square_counts, vector<double>* histogram) {
+	cache.clear();
+	aborted = false;
+	nodes = 0;
+	cache_hits = 0;
+	max_components = 0;
+	assignment.assign(num_squares, -1);
+	trail.clear();
+
+	vector<CountConstraint> residual = *constraints;
+	for (CountConstraint& c : residual) {
+		sort(c.squares.begin(), c.squares.end());
+	}
+	vector<int> squares;
+	for (int i = 0; i < num_squares; i++) {
+		squares.push_back(i);
+	}
+	ComponentCount result = count_residual(&residual, &squares);
+	if (aborted) {
+		return false;
+	}
+	*square_counts = result.square_counts;
+	*histogram = result.histogram;
+	return true;
+}
+
+//Number of ways to choose k of n items
+static double binomial(int n, int k) {
+	if (k < 0 || k > n) {
+		return 0;
+	}
+	double result = 1;
+	for (int i = 1; i <= k; i++) {
+		result = result * (n - k + i) / i;
+	}
+	return result;
+}
+
+//Count possibilities of a connected set of constraints, branching on the square in the most constraints
+ComponentCount ModelCounter::count_component(vector<CountConstraint>* constraints, vector<int>* squares) {
+	string key = component_key(constraints);
+	unordered_map<string, ComponentCount>::iterator cached = cache.find(key);
+	if (cached != cache.end()) {
+		cache_hits++;
+		return cached->second;
+	}
+
+	ComponentCount result;
+	result.histogram.assign(squares->size() + 1, 0);
+	result.square_counts.assign(squares->size(), 0);
+	nodes++;
+	if (nodes > MODEL_COUNT_NODE_LIMIT || ((nodes & 1023) == 0 && use_deadline && chrono::steady_clock::now() > deadline)) {
+		aborted = true;
+	}
+	if (aborted) {
+		return result;
+	}
+
+	if (constraints->size() == 1) { //A lone constraint places its mines among its squares in any way
+		int n = squares->size();
+		int r = (*constraints)[0].remaining;
+		result.histogram[r] = binomial(n, r);
+		result.square_counts.assign(n, binomial(n - 1, r - 1));
+		cache[key] = result;
+		return result;
+	}
+
+	unordered_map<int, int> occurrences; //Choose branching square
+	int branch = (*squares)[0];
+	for (CountConstraint& c : *constraints) {
+		for (int s : c.squares) {
+			if (++occurrences[s] > occurrences[branch]) {
+				branch = s;
+			}
+		}
+	}
+
+	for (int value = 0; value <= 1; value++) {
+		vector<CountConstraint> residual = *constraints;
+		int trail_size = trail.size();
+		assignment[branch] = value;
+		trail.push_back(branch);
+		ComponentCount branch_result = count_residual(&residual, squares);
+		while (trail.size() > trail_size) { //Undo assignments of this branch
+			assignment[trail.back()] = -1;
+			trail.pop_back();
+		}
+		for (int k = 0; k < result.histogram.size(); k++) {
+			result.histogram[k] += branch_result.histogram[k];
+		}
+		for (int k = 0; k < result.square_counts.size(); k++) {
+			result.square_counts[k] += branch_result.square_counts[k];
+		}
+	}
+
+	if (!aborted) {
+		cache[key] = result;
+	}
+	return result;
+}
+
+//Count possibilities of squares (sorted) after propagating the current assignment through the constraints
+//The remaining constraints are split into independent components whose counts are combined
+ComponentCount ModelCounter::count_residual(vector<CountConstraint>* constraints, vector<int>* squares) {
+	ComponentCount result;
+	result.histogram.assign(squares->size() + 1, 0);
+	result.square_counts.assign(squares->size(), 0);
+	if (!propagate(constraints)) {
+		return result; //No possibilities
+	}
+
+	//Combine components one at a time, starting from the single possibility of no squares
+	vector<double> histogram(1, 1);
+	vector<double> counts(squares->size(), 0);
+	vector<bool> constrained(squares->size(), false);
+	vector<vector<CountConstraint>> components = split_components(constraints);
+	max_components = max(max_components, (int)components.size());
+	for (vector<CountConstraint>& component : components) {
+		vector<int> component_squares;
+		for (CountConstraint& c : component) {
+			component_squares.insert(component_squares.end(), c.squares.begin(), c.squares.end());
+		}
+		sort(component_squares.begin(), component_squares.end());
+		component_squares.erase(unique(component_squares.begin(), component_squares.end()), component_squares.end());
+
+		ComponentCount component_result = count_component(&component, &component_squares);
+		if (aborted) {
+			return result;
+		}
+		double total = 0;
+		for (double h : histogram) {
+			total += h;
+		}
+		double component_total = 0;
+		for (double h : component_result.histogram) {
+			component_total += h;
+		}
+		for (int k = 0; k < counts.size(); k++) { //Each possibility so far pairs with each possibility of the component
+			counts[k] *= component_total;
+		}
+		for (int k = 0; k < component_squares.size(); k++) {
+			int index = lower_bound(squares->begin(), squares->end(), component_squares[k]) - squares->begin();
+			counts[index] = component_result.square_counts[k] * total;
+			constrained[index] = true;
+		}
+		vector<double> combined(histogram.size() + component_result.histogram.size() - 1, 0);
+		for (int a = 0; a < histogram.size(); a++) {
+			for (int b = 0; b < component_result.histogram.size(); b++) {
+				combined[a + b] += histogram[a] * component_result.histogram[b];
+			}
+		}
+		histogram = combined;
+	}
+
+	//Add squares assigned by branching and propagation, and unconstrained squares (each either safe or a mine)
+	double total = 0;
+	for (double h : histogram) {
+		total += h;
+	}
+	int assigned_mines = 0;
+	for (int k = 0; k < squares->size(); k++) {
+		if (assignment[(*squares)[k]] == 1) {
+			counts[k] = total;
+			assigned_mines++;
+		}
+		else if (assignment[(*squares)[k]] < 0 && !constrained[k]) {
+			for (int m = 0; m < counts.size(); m++) {
+				counts[m] *= 2;
+			}
+			counts[k] = total;
+			histogram.push_back(0);
+			for (int m = histogram.size() - 1; m > 0; m--) {
+				histogram[m] += histogram[m - 1];
+			}
+			total *= 2;
+		}
+	}
+	for (int k = 0; k < histogram.size() && k + assigned_mines < result.histogram.size(); k++) {
+		result.histogram[k + assigned_mines] = histogram[k];
+	}
+	result.square_counts = counts;
+	return result;
+}
+
+//Remove assigned squares from constraints, assigning squares of constraints that can only be satisfied one way
+//Satisfied constraints are removed, returns false if any constraint can no longer be satisfied
+bool ModelCounter::propagate(vector<CountConstraint>* constraints) {
+	bool changed = true;
+	while (changed) {
+		changed = false;
+		for (int i = 0; i < constraints->size(); i++) {
+			CountConstraint& c = (*constraints)[i];
+			int kept = 0;
+			for (int s : c.squares) { //Remove assigned squares
+				if (assignment[s] < 0) {
+					c.squares[kept++] = s;
+				}
+				else {
+					c.remaining -= assignment[s];
+				}
+			}
+			c.squares.resize(kept);
+			if (c.remaining < 0 || c.remaining > kept) {
+				return false;
+			}
+			if (kept > 0 && (c.remaining == 0 || c.remaining == kept)) { //Every square is safe, or every square is a mine
+				for (int s : c.squares) {
+					assignment[s] = c.remaining == 0 ? 0 : 1;
+					trail.push_back(s);
+				}
+				c.squares.clear();
+				c.remaining = 0;
+				changed = true;
+			}
+		}
+	}
+	constraints->erase(remove_if(constraints->begin(), constraints->end(), [](const CountConstraint& c) { return c.squares.empty(); }), constraints->end());
+	return true;
+}
+
+//Split constraints into groups sharing no squares
+vector<vector<CountConstraint>> ModelCounter::split_components(vector<CountConstraint>* constraints) {
+	vector<int> parent(constraints->size());
+	for (int i = 0; i < parent.size(); i++) {
+		parent[i] = i;
+	}
+	auto find = [&parent](int i) {
+		while (parent[i] != i) {
+			parent[i] = parent[parent[i]];
+			i = parent[i];
+		}
+		return i;
+	};
+	unordered_map<int, int> owner; //First constraint containing each square
+	for (int i = 0; i < constraints->size(); i++) {
+		for (int s : (*constraints)[i].squares) {
+			unordered_map<int, int>::iterator it = owner.find(s);
+			if (it == owner.end()) {
+				owner[s] = i;
+			}
+			else {
+				parent[find(i)] = find(it->second);
+			}
+		}
+	}
+
+	vector<vector<CountConstraint>> components;
+	unordered_map<int, int> component_index;
+	for (int i = 0; i < constraints->size(); i++) {
+		int root = find(i);
+		if (component_index.find(root) == component_index.end()) {
+			component_index[root] = components.size();
+			components.push_back(vector<CountConstraint>());
+		}
+		components[component_index[root]].push_back((*constraints)[i]);
+	}
+	return components;
+}
+
+//Key identifying a component by its constraints (sorted) with their remaining counts
+string ModelCounter::component_key(vector<CountConstraint>* constraints) {
+	vector<string> parts;
+	for (CountConstraint& c : *constraints) {
+		string part;
+		part.push_back((char)c.remaining);
+		part.push_back((char)c.squares.size());
+		for (int s : c.squares) {
+			part.append((char*)&s, sizeof(int));
+		}
+		parts.push_back(part);
+	}
+	sort(parts.begin(), parts.end());
+	string key;
+	for (string& part : parts) {
+		key += part;
+	}
+	return key;
+}
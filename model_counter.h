@@ -0,0 +1,55 @@
+#ifndef MODEL_COUNTER_H
+#define MODEL_COUNTER_H
+
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <chrono>
+
+#define MODEL_COUNT_NODE_LIMIT 1000000 //Maximum number of branches before giving up on an edge
+
+struct CountConstraint { //Unassigned squares of a constraint and the number of mines still to place among them
+	std::vector<int> squares;
+	int remaining;
+};
+
+struct ComponentCount { //Possibilities of a set of squares
+	std::vector<double> histogram; //Possibilities by number of mines
+	std::vector<double> square_counts; //Possibilities with each square (in ascending order) as a mine
+};
+
+//Exact counter of the possibilities of an edge, branching on one square at a time
+//After each branch, forced squares are propagated and the remaining constraints are split into independent components,
+//each counted separately and cached, so components seen again (including those with no possibilities) are not searched twice
+class ModelCounter {
+public:
+	ModelCounter();
+	void set_deadline(std::chrono::steady_clock::time_point deadline, bool enabled);
+
+	//Count possibilities of squares 0 to num_squares - 1, returns false if out of time or over the node limit
+	bool count(int num_squares, std::vector<CountConstraint>* constraints, std::vector<double>* square_counts, std::vector<double>* histogram);
+
+	//Stats from the last count
+	int get_nodes();
+	int get_cache_hits();
+	int get_max_components();
+
+private:
+	ComponentCount count_component(std::vector<CountConstraint>* constraints, std::vector<int>* squares);
+	ComponentCount count_residual(std::vector<CountConstraint>* constraints, std::vector<int>* squares);
+	bool propagate(std::vector<CountConstraint>* constraints);
+	std::vector<std::vector<CountConstraint>> split_components(std::vector<CountConstraint>* constraints);
+	std::string component_key(std::vector<CountConstraint>* constraints);
+
+	std::unordered_map<std::string, ComponentCount> cache;
+	std::vector<int> assignment; //Value of each square (-1 if unassigned)
+	std::vector<int> trail; //Assigned squares in order of assignment
+	std::chrono::steady_clock::time_point deadline;
+	bool use_deadline;
+	bool aborted;
+	int nodes;
+	int cache_hits;
+	int max_components;
+};
+
+#endif //MODEL_COUNTER_H
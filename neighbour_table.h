@@ -0,0 +1,38 @@
+#ifndef NEIGHBOUR_TABLE_H
+#define NEIGHBOUR_TABLE_H
+
+#include "util.h"
+
+//Neighbours of every square of a board with a fixed size, generated at compile time
+//Squares are numbered in row-major order, and the neighbours of each square are listed in the order of DIRECTIONS,
+//so that searches using the table visit squares in the same order as execute_callback
+template <int ROWS, int COLS>
+struct NeighbourTable {
+	int counts[ROWS * COLS]; //Number of neighbours on the board
+	int squares[ROWS * COLS][8]; //Neighbours on the board, the first counts[p] entries are used
+
+	constexpr NeighbourTable() : counts(), squares() {
+		for (int i = 0; i < ROWS; i++) {
+			for (int j = 0; j < COLS; j++) {
+				int p = i * COLS + j;
+				for (int k = 0; k < 8; k++) {
+					int ni = i + DIRECTIONS[k][0];
+					int nj = j + DIRECTIONS[k][1];
+					if (ni >= 0 && ni < ROWS && nj >= 0 && nj < COLS) {
+						squares[p][counts[p]] = ni * COLS + nj;
+						counts[p] += 1;
+					}
+				}
+			}
+		}
+	}
+};
+
+template <int ROWS, int COLS>
+constexpr NeighbourTable<ROWS, COLS> NEIGHBOUR_TABLE = NeighbourTable<ROWS, COLS>();
+
+//Corner squares have 3 neighbours, other border squares 5 and interior squares 8
+static_assert(NEIGHBOUR_TABLE<9, 9>.counts[0] == 3 && NEIGHBOUR_TABLE<9, 9>.counts[4] == 5 && NEIGHBOUR_TABLE<9, 9>.counts[40] == 8, "neighbour table miscounts borders");
+static_assert(NEIGHBOUR_TABLE<16, 30>.squares[0][0] == 1 && NEIGHBOUR_TABLE<16, 30>.squares[0][1] == 30, "neighbour table out of order");
+
+#endif //NEIGHBOUR_TABLE_H
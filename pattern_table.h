@@ -0,0 +1,86 @@
+#ifndef PATTERN_TABLE_H
+#define PATTERN_TABLE_H
+
+#include <cstdint>
+
+//Lookup tables solving edges of up to PATTERN_SQUARES squares, generated at compile time
+//Each of the 2^PATTERN_SQUARES possibilities of an edge is one bit of a 64 bit word, so a set of possibilities is a single word
+//A constraint touching the squares in a mask with a remaining count allows exactly the possibilities in CONSTRAINT_TABLE[mask][count],
+//and the valid possibilities of an edge are the bitwise and of one lookup per constraint
+#define PATTERN_SQUARES 6
+#define PATTERN_POSSIBILITIES (1 << PATTERN_SQUARES)
+#define PATTERN_MAX_COUNT 8
+
+struct PatternTable {
+	uint64_t constraints[PATTERN_POSSIBILITIES][PATTERN_MAX_COUNT + 1]; //Possibilities placing count mines in mask
+	uint64_t squares[PATTERN_SQUARES]; //Possibilities with each square as a mine
+	uint64_t mines[PATTERN_SQUARES + 1]; //Possibilities with each number of mines
+
+	//Build tables by enumerating the submasks of each constraint mask
+	constexpr PatternTable() : constraints(), squares(), mines() {
+		for (int mask = 0; mask < PATTERN_POSSIBILITIES; mask++) {
+			int sub = mask;
+			while (true) { //Every possibility whose mines within the mask are exactly sub
+				int count = 0;
+				for (int bits = sub; bits != 0; bits &= bits - 1) {
+					count += 1;
+				}
+				for (int p = 0; p < PATTERN_POSSIBILITIES; p++) {
+					if ((p & mask) == sub) {
+						constraints[mask][count] |= 1ULL << p;
+					}
+				}
+				if (sub == 0) {
+					break;
+				}
+				sub = (sub - 1) & mask;
+			}
+		}
+		for (int p = 0; p < PATTERN_POSSIBILITIES; p++) {
+			int count = 0;
+			for (int j = 0; j < PATTERN_SQUARES; j++) {
+				if ((p >> j) & 1) {
+					squares[j] |= 1ULL << p;
+					count += 1;
+				}
+			}
+			mines[count] |= 1ULL << p;
+		}
+	}
+};
+
+constexpr PatternTable PATTERN_TABLE = PatternTable();
+
+//Number of set bits in a word
+inline int popcount64(uint64_t x) {
+	x = x - ((x >> 1) & 0x5555555555555555ULL);
+	x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+	x = (x + (x >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+	return (int)((x * 0x0101010101010101ULL) >> 56);
+}
+
+//Check each table entry against brute force, testing every possibility against the constraint directly
+constexpr bool pattern_table_matches_brute_force() {
+	for (int mask = 0; mask < PATTERN_POSSIBILITIES; mask++) {
+		for (int count = 0; count <= PATTERN_MAX_COUNT; count++) {
+			for (int p = 0; p < PATTERN_POSSIBILITIES; p++) {
+				int placed = 0;
+				for (int j = 0; j < PATTERN_SQUARES; j++) {
+					if (((mask >> j) & 1) && ((p >> j) & 1)) {
+						placed += 1;
+					}
+				}
+				bool allowed = (PATTERN_TABLE.constraints[mask][count] >> p) & 1;
+				if (allowed != (placed == count)) {
+					return false;
+				}
+			}
+		}
+	}
+	return true;
+}
+
+static_assert(pattern_table_matches_brute_force(), "Pattern table does not match brute force search");
+static_assert((PATTERN_TABLE.constraints[0b011][1] & PATTERN_TABLE.constraints[0b111][2] & PATTERN_TABLE.constraints[0b110][1] & 0xFF) == 1ULL << 0b101, "1-2-1 pattern must only have mines on its outer squares");
+
+#endif //PATTERN_TABLE_H
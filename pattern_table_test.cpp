@@ -0,0 +1,111 @@
+#include "bot.h"
+#include "solver.h"
+#include "pattern_table.h"
+#include <iostream>
+#include <random>
+#include <math.h>
+
+using namespace std;
+
+#define TEST_BOARDS 20000
+#define TEST_TOLERANCE 1e-9
+
+//Solves random edges of up to PATTERN_SQUARES squares with both the pattern table and the brute force search,
+//checking that they give the same probabilities, mines per possibility and histogram of possibilities by number of mines
+class PatternTableTest {
+public:
+	//Returns the number of edges compared, or -1 on the first mismatch
+	static int run(unsigned seed) {
+		mt19937 rng(seed);
+		int compared = 0;
+		for (int b = 0; b < TEST_BOARDS; b++) {
+			int rows = 3 + rng() % 4;
+			int cols = 3 + rng() % 4;
+			int mines = 1 + rng() % (rows * cols / 2);
+
+			//Random layout, with some safe squares revealed and some mines marked
+			vector<State> states(rows * cols, UNREVEALED_SAFE);
+			for (int k = 0; k < mines; k++) {
+				int p;
+				do {
+					p = rng() % (rows * cols);
+				} while (states[p] == UNREVEALED_MINE);
+				states[p] = UNREVEALED_MINE;
+			}
+			vector<int> counts(rows * cols, 0);
+			for (int i = 0; i < rows; i++) {
+				for (int j = 0; j < cols; j++) {
+					for (int di = -1; di <= 1; di++) {
+						for (int dj = -1; dj <= 1; dj++) {
+							int ni = i + di;
+							int nj = j + dj;
+							if ((di != 0 || dj != 0) && ni >= 0 && ni < rows && nj >= 0 && nj < cols && states[ni * cols + nj] == UNREVEALED_MINE) {
+								counts[i * cols + j] += 1;
+							}
+						}
+					}
+				}
+			}
+			for (int p = 0; p < rows * cols; p++) {
+				if (states[p] == UNREVEALED_SAFE && rng() % 3 == 0) {
+					states[p] = KNOWN_SAFE;
+				}
+				else if (states[p] == UNREVEALED_MINE && rng() % 4 == 0) {
+					states[p] = KNOWN_MINE;
+				}
+			}
+
+			SolverView view = { rows, cols, mines, states.data(), counts.data() };
+			SolverBoard board;
+			board.load(view);
+			Bot bot;
+			bot.set_verbose(false);
+			bot.set_board(&board);
+			vector<vector<pair<int, int>>*>* edges = bot.get_edges();
+			for (vector<pair<int, int>>* edge : *edges) {
+				if (edge->size() > PATTERN_SQUARES) {
+					continue;
+				}
+				double table_mines = bot.update_probabilities_table(edge);
+				vector<double> table_probabilities;
+				for (pair<int, int> p : *edge) {
+					table_probabilities.push_back(bot.m_probabilities[p.first][p.second]);
+				}
+				vector<double> table_histogram = bot.edge_histogram;
+
+				double precise_mines = bot.update_probabilities_precise(edge);
+				bool match = fabs(table_mines - precise_mines) < TEST_TOLERANCE && table_histogram == bot.edge_histogram;
+				for (int k = 0; k < edge->size(); k++) {
+					pair<int, int> p = (*edge)[k];
+					match = match && fabs(table_probabilities[k] - bot.m_probabilities[p.first][p.second]) < TEST_TOLERANCE;
+				}
+				if (!match) {
+					cout << "Mismatch on board " << b << " (" << rows << "x" << cols << ", " << mines << " mines), edge of " << edge->size() << " squares:" << endl;
+					for (int k = 0; k < edge->size(); k++) {
+						pair<int, int> p = (*edge)[k];
+						cout << "\t" << p.first << "," << p.second << ": table " << table_probabilities[k] << ", brute force " << bot.m_probabilities[p.first][p.second] << endl;
+					}
+					cout << "\tMines per possibility: table " << table_mines << ", brute force " << precise_mines << endl;
+					return -1;
+				}
+				compared += 1;
+			}
+			while (!edges->empty()) { //Cleanup
+				delete edges->back();
+				edges->pop_back();
+			}
+			delete edges;
+		}
+		return compared;
+	}
+};
+
+int main(int argc, char* argv[]) {
+	unsigned seed = argc > 1 ? (unsigned)atoi(argv[1]) : 1;
+	int compared = PatternTableTest::run(seed);
+	if (compared < 0) {
+		return 1;
+	}
+	cout << "Pattern table matches brute force search on " << compared << " edges" << endl;
+	return compared > 0 ? 0 : 1;
+}
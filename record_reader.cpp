@@ -0,0 +1,99 @@
+// record_reader.cpp : Summary of the game records written by the minesweeper solver with --records.
+// Reads the file one block at a time, so files of any number of games are summarised in constant memory.
+//
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <string.h>
+#include <errno.h>
+#include "game_record.h"
+
+using namespace std;
+
+#define GUESS_BUCKETS 10 //Losses on this many guesses or more share the last bucket
+
+//Main method
+int main(int argc, char** argv) {
+	if (argc < 2 || strcmp(argv[1], "-h") == 0 || strcmp(argv[1], "--help") == 0) {
+		cout << "Summarise a game record file written with --records." << endl;
+		cout << "Usage: minesweeper_records [file] [--losses (-l)]" << endl;
+		cout << "	--losses (-l): Also print the seed, moves, guesses and largest edge of each lost game" << endl;
+		return argc < 2 ? EINVAL : 0;
+	}
+	bool list_losses = argc > 2 && (strcmp(argv[2], "-l") == 0 || strcmp(argv[2], "--losses") == 0);
+
+	RecordReader reader;
+	if (!reader.open(argv[1])) {
+		cout << "Could not read record file " << argv[1] << endl;
+		return ENOENT;
+	}
+
+	long long games = 0;
+	long long wins = 0;
+	long long moves = 0;
+	long long guesses = 0;
+	long long edge_squares = 0;
+	int largest_edge = 0;
+	long long memory = 0;
+	long long max_memory = 0;
+	double times[4]{ 0, 0, 0, 0 };
+	double slowest = -1;
+	string slowest_seed;
+	vector<long long> losses_by_guesses(GUESS_BUCKETS + 1, 0);
+	RecordBlock block;
+	int blocks = 0;
+	while (reader.next(&block)) {
+		blocks += 1;
+		for (int k = 0; k < block.size(); k++) {
+			games += 1;
+			wins += block.results[k] == WIN;
+			moves += block.moves[k];
+			guesses += block.guesses[k];
+			edge_squares += block.largest_edges[k];
+			largest_edge = max(largest_edge, block.largest_edges[k]);
+			memory += block.peak_memory[k];
+			max_memory = max(max_memory, block.peak_memory[k]);
+			times[0] += block.single_square_times[k];
+			times[1] += block.pairwise_times[k];
+			times[2] += block.edge_times[k];
+			times[3] += block.guess_times[k];
+			double total = block.single_square_times[k] + block.pairwise_times[k] + block.edge_times[k] + block.guess_times[k];
+			if (total > slowest) {
+				slowest = total;
+				slowest_seed = block.get_seed(k);
+			}
+			if (block.results[k] == LOSS) {
+				losses_by_guesses[min(block.guesses[k], GUESS_BUCKETS)] += 1;
+				if (list_losses) {
+					cout << block.get_seed(k) << " moves " << block.moves[k] << " guesses " << block.guesses[k] << " largest_edge " << block.largest_edges[k] << endl;
+				}
+			}
+		}
+	}
+	if (games == 0) {
+		cout << "No games recorded" << endl;
+		return 0;
+	}
+
+	double total_time = times[0] + times[1] + times[2] + times[3];
+	cout << "Games: " << games << " in " << blocks << " blocks" << endl;
+	cout << "Won: " << wins << " (" << 100.0 * wins / games << "%)" << endl;
+	cout << "Moves per game: " << (double)moves / games << ", guesses per game: " << (double)guesses / games << endl;
+	cout << "Losses by number of guesses made:" << endl;
+	for (int k = 0; k <= GUESS_BUCKETS; k++) {
+		if (losses_by_guesses[k] > 0) {
+			cout << "\t" << k << (k == GUESS_BUCKETS ? "+" : "") << ": " << losses_by_guesses[k] << " (" << 100.0 * losses_by_guesses[k] / (games - wins) << "%)" << endl;
+		}
+	}
+	const char* names[4]{ "single square", "pairwise", "edge", "guess" };
+	cout << "Search time per game: " << total_time / games / 1000 << " ms" << endl;
+	for (int k = 0; k < 4; k++) {
+		cout << "\t" << names[k] << ": " << times[k] / games / 1000 << " ms (" << (total_time > 0 ? 100.0 * times[k] / total_time : 0) << "%)" << endl;
+	}
+	cout << "Slowest game: " << slowest / 1000 << " ms, seed " << slowest_seed << endl;
+	cout << "Largest edge: " << (double)edge_squares / games << " squares on average, " << largest_edge << " at most" << endl;
+	cout << "Peak sub-edge tree memory: " << memory / games / 1024 << " KB on average, " << max_memory / 1024 << " KB at most" << endl;
+	return 0;
+}
@@ -0,0 +1,305 @@
+#include "seed_runner.h"
+#include "board.h"
+#include "bot.h"
+#include <chrono>
+#include <fstream>
+#include <algorithm>
+#ifdef _WIN32
+#include <iterator>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+using namespace std;
+
+//Initialization with default bot settings, workers are started by run
+SeedRunner::SeedRunner(int rows, int columns, int num_mines, int num_workers)
+	: m_rows(rows), m_cols(columns), m_mines(num_mines), m_workers(num_workers)
+{
+	MAX_SIZE = 10;
+	subset_approximation = true;
+	edge_reduction = false;
+	model_counting = false;
+	endgame_squares = 0;
+	endgame_mines = 0;
+	lookahead_candidates = 0;
+	lookahead_time = 0;
+	time_budget = 0;
+	sample_budget = 0;
+	node_budget = SECTIONED_NODE_BUDGET;
+	memory_budget = SECTIONED_MEMORY_BUDGET;
+	cost_model = nullptr;
+	move_target = 0;
+	records = nullptr;
+	output = nullptr;
+	games = 0;
+	wins = 0;
+	invalid = 0;
+	elapsed = 0;
+}
+
+//Set maximum edge length searched without approximation
+void SeedRunner::set_edge_search_limit(int size) {
+	MAX_SIZE = size;
+}
+
+//Enable/disable subset approximation for large edges
+void SeedRunner::set_edge_subset_approximation(bool approximate) {
+	subset_approximation = approximate;
+}
+
+//Enable/disable Gaussian elimination of edge constraints
+void SeedRunner::set_edge_reduction(bool reduce) {
+	edge_reduction = reduce;
+}
+
+//Enable/disable exact model counting of large edges
+void SeedRunner::set_model_counting(bool count) {
+	model_counting = count;
+}
+
+//Set number of unknown squares and mines left below which the whole board is solved exactly
+void SeedRunner::set_endgame_thresholds(int squares, int mines) {
+	endgame_squares = squares;
+	endgame_mines = mines;
+}
+
+//Set number of guesses compared by lookahead and the time allowed for it
+void SeedRunner::set_lookahead(int candidates, double milliseconds) {
+	lookahead_candidates = candidates;
+	lookahead_time = milliseconds;
+}
+
+//Set maximum search time per move in milliseconds (0 for no limit)
+void SeedRunner::set_move_time_budget(double milliseconds) {
+	time_budget = milliseconds;
+}
+
+//Set number of samples used for large edges (0 to disable sampling)
+void SeedRunner::set_sample_budget(int samples) {
+	sample_budget = samples;
+}
+
+//Set node and memory budgets of each worker's sub-edge trees (0 for no limit)
+void SeedRunner::set_sectioned_budget(int nodes, int megabytes) {
+	node_budget = nodes;
+	memory_budget = megabytes;
+}
+
+//Set cost model shared by every worker's bot, and the time aimed for per move in milliseconds (0 to only record search times)
+void SeedRunner::set_cost_model(CostModel* model, double target_milliseconds) {
+	cost_model = model;
+	move_target = target_milliseconds;
+}
+
+//Set writer recording every game played (nullptr to not record them)
+void SeedRunner::set_record_writer(RecordWriter* writer) {
+	records = writer;
+}
+
+//Map the file into memory, play its seeds on the workers and wait for every result to be written
+bool SeedRunner::run(string path, ostream& out) {
+	games = 0;
+	wins = 0;
+	invalid = 0;
+	elapsed = 0;
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+#ifdef _WIN32
+	ifstream in(path, ios::binary); //No memory mapping, read the whole file at once
+	if (!in) {
+		return false;
+	}
+	vector<char> contents((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+	const char* data = contents.data();
+	long long size = contents.size();
+#else
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd < 0) {
+		return false;
+	}
+	struct stat info;
+	if (fstat(fd, &info) != 0) {
+		close(fd);
+		return false;
+	}
+	long long size = info.st_size;
+	const char* data = nullptr;
+	if (size > 0) {
+		void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (mapped == MAP_FAILED) {
+			close(fd);
+			return false;
+		}
+		madvise(mapped, size, MADV_SEQUENTIAL); //Chunks are claimed in order, so read ahead
+		data = (const char*)mapped;
+	}
+	close(fd);
+#endif
+
+	output = &out;
+	next_chunk = 0;
+	next_write = 0;
+	finished.clear();
+	vector<thread> workers;
+	for (int i = 0; i < m_workers; i++) {
+		workers.push_back(thread(&SeedRunner::worker, this, data, size));
+	}
+	for (thread& t : workers) {
+		t.join();
+	}
+	out.flush();
+
+#ifndef _WIN32
+	if (data != nullptr) {
+		munmap((void*)data, size);
+	}
+#endif
+	elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+	return true;
+}
+
+//Claim chunks in order and play them on this worker's own quiet board until the file is done
+//A worker does not claim a chunk more than SEED_CHUNK_WINDOW chunks per worker past the first chunk not yet written,
+//so the results waiting to be written stay bounded even behind a slow chunk
+void SeedRunner::worker(const char* data, long long size) {
+	Board* board = new Board(m_rows, m_cols, m_mines, "", false);
+	configure(board);
+	RecordBlock block;
+	block.rows = m_rows;
+	block.cols = m_cols;
+	string results;
+	while (true) {
+		long long chunk;
+		{
+			unique_lock<mutex> guard(chunk_lock);
+			chunk_written.wait(guard, [this] { return next_chunk < next_write + (long long)SEED_CHUNK_WINDOW * m_workers; });
+			chunk = next_chunk;
+			next_chunk += 1;
+		}
+		if (chunk * SEED_CHUNK_BYTES >= size) {
+			break;
+		}
+		results.clear();
+		play_chunk(board, data, size, chunk, &results, &block);
+		write_chunk(chunk, results);
+	}
+	if (records != nullptr) {
+		records->flush(&block);
+	}
+	delete board;
+}
+
+//Play every line starting in the chunk, appending one result per seed (lines left empty are skipped)
+void SeedRunner::play_chunk(Board* board, const char* data, long long size, long long chunk, string* results, RecordBlock* block) {
+	long long begin = chunk * SEED_CHUNK_BYTES;
+	long long end = min(size, begin + SEED_CHUNK_BYTES);
+	long long p = begin;
+	if (p > 0 && data[p - 1] != '\n') { //Line started in the chunk before
+		while (p < size && data[p] != '\n') {
+			p++;
+		}
+		p++;
+	}
+
+	long long chunk_games = 0;
+	long long chunk_wins = 0;
+	long long chunk_invalid = 0;
+	string layout;
+	while (p < end) {
+		long long q = p;
+		while (q < size && data[q] != '\n') {
+			q++;
+		}
+		long long length = q - p;
+		if (length > 0 && data[q - 1] == '\r') {
+			length--;
+		}
+		if (length > 0) {
+			Board::decompress_seed(data + p, length, &layout);
+			int mines = 0;
+			unsigned long long layout_hash = 0;
+			for (int k = 0; k < layout.length(); k++) {
+				if (layout[k] == '1') {
+					mines += 1;
+					layout_hash = mix_hash(layout_hash ^ k);
+				}
+			}
+			if (layout.length() != m_rows * m_cols || mines != m_mines) {
+				*results += "invalid\n";
+				chunk_invalid += 1;
+			}
+			else {
+				board->load_seed(layout);
+				board->get_bot()->set_random_seed((unsigned)layout_hash); //Sampling and guesses only depend on the seed, not on the games the worker played before
+				MoveResult res;
+				int moves = 0;
+				do {
+					res = board->get_bot()->select_next_move();
+					moves++;
+				} while (res == CONTINUE);
+				*results += res == WIN ? "win " : "loss ";
+				*results += to_string(moves);
+				*results += '\n';
+				chunk_games += 1;
+				chunk_wins += res == WIN;
+				if (records != nullptr) {
+					records->record(block, board->get_seed(), res, board->get_bot()->get_game_stats(), board->get_bot()->get_max_search_memory());
+				}
+			}
+		}
+		p = q + 1;
+	}
+
+	lock_guard<mutex> guard(chunk_lock);
+	games += chunk_games;
+	wins += chunk_wins;
+	invalid += chunk_invalid;
+}
+
+//Hold the chunk's results until every chunk before it is written, then write it and any held chunks following it
+void SeedRunner::write_chunk(long long chunk, string& results) {
+	{
+		lock_guard<mutex> guard(chunk_lock);
+		finished[chunk].swap(results);
+		while (!finished.empty() && finished.begin()->first == next_write) {
+			*output << finished.begin()->second;
+			finished.erase(finished.begin());
+			next_write += 1;
+		}
+	}
+	chunk_written.notify_all();
+}
+
+//Apply the runner's settings to the bot of a worker's board
+void SeedRunner::configure(Board* board) {
+	Bot* bot = board->get_bot();
+	bot->set_edge_search_limit(MAX_SIZE);
+	bot->set_edge_subset_approximation(subset_approximation);
+	bot->set_edge_reduction(edge_reduction);
+	bot->set_model_counting(model_counting);
+	bot->set_endgame_thresholds(endgame_squares, endgame_mines);
+	bot->set_lookahead(lookahead_candidates, lookahead_time);
+	bot->set_move_time_budget(time_budget);
+	bot->set_sample_budget(sample_budget);
+	bot->set_sectioned_budget(node_budget, memory_budget);
+	bot->set_cost_model(cost_model, move_target);
+}
+
+//Print out the results and throughput of the last run
+void SeedRunner::print_stats() {
+	cout << "Played " << games << " games in " << elapsed << " seconds (" << get_games_per_second() << " games/sec)" << endl;
+	cout << "Won: " << wins << " (" << (games > 0 ? 100.0 * wins / games : 0) << "%)" << endl;
+	cout << "Invalid seeds: " << invalid << endl;
+}
+
+//Throughput of the last run
+double SeedRunner::get_games_per_second() {
+	if (elapsed <= 0) {
+		return 0;
+	}
+	return games / elapsed;
+}
@@ -0,0 +1,93 @@
+#ifndef SEED_RUNNER_H
+#define SEED_RUNNER_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <iostream>
+#include "util.h"
+#include "cost_model.h"
+#include "game_record.h"
+
+#define SEED_CHUNK_BYTES 65536 //Bytes of the seed file claimed by a worker at a time
+#define SEED_CHUNK_WINDOW 4 //Chunks each worker may run ahead of the first chunk not yet written
+
+class Board;
+
+//Plays every seed of a file (one compressed seed per line) on several threads, writing one result per seed in input order
+//The file is memory-mapped and split into chunks of bytes claimed by the workers, each playing the lines starting in its chunk,
+//so seeds are read in place rather than line by line, and results of chunks finished early only wait for the chunks before them
+class SeedRunner {
+public:
+	//Initialization
+	SeedRunner(int rows, int columns, int num_mines, int num_workers);
+
+	//Settings applied to the bot of every worker
+	void set_edge_search_limit(int size);
+	void set_edge_subset_approximation(bool approximate);
+	void set_edge_reduction(bool reduce);
+	void set_model_counting(bool count);
+	void set_endgame_thresholds(int squares, int mines);
+	void set_lookahead(int candidates, double milliseconds);
+	void set_move_time_budget(double milliseconds);
+	void set_sample_budget(int samples);
+	void set_sectioned_budget(int nodes, int megabytes);
+	void set_cost_model(CostModel* model, double target_milliseconds);
+	void set_record_writer(RecordWriter* writer);
+
+	//Key method: play every seed of the file, writing "win [moves]", "loss [moves]" or "invalid" for each, returns false if the file cannot be read
+	bool run(std::string path, std::ostream& out);
+
+	//Stats of the last run
+	void print_stats();
+	double get_games_per_second();
+
+private:
+	//Workers
+	void worker(const char* data, long long size);
+	void play_chunk(Board* board, const char* data, long long size, long long chunk, std::string* results, RecordBlock* block);
+	void write_chunk(long long chunk, std::string& results);
+	void configure(Board* board);
+
+	//Board setup values
+	int m_rows;
+	int m_cols;
+	int m_mines;
+	int m_workers;
+
+	//Settings
+	int MAX_SIZE;
+	bool subset_approximation;
+	bool edge_reduction;
+	bool model_counting;
+	int endgame_squares;
+	int endgame_mines;
+	int lookahead_candidates;
+	double lookahead_time;
+	double time_budget;
+	int sample_budget;
+	int node_budget;
+	int memory_budget;
+	CostModel* cost_model;
+	double move_target;
+	RecordWriter* records; //Records of every game, each worker buffering its own (nullptr to not record them)
+
+	//Chunks claimed by the workers and results waiting for the chunks before them
+	std::mutex chunk_lock;
+	std::condition_variable chunk_written;
+	long long next_chunk;
+	long long next_write;
+	std::map<long long, std::string> finished;
+	std::ostream* output;
+
+	//Stats
+	long long games;
+	long long wins;
+	long long invalid;
+	double elapsed;
+};
+
+#endif //SEED_RUNNER_H
@@ -0,0 +1,517 @@
+#include "server.h"
+#include "board.h"
+#include "bot.h"
+#include <sstream>
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+//Split a request into its words
+static vector<string> split_words(const string& line) {
+	vector<string> words;
+	istringstream in(line);
+	string word;
+	while (in >> word) {
+		words.push_back(word);
+	}
+	return words;
+}
+
+//Parse a non-negative integer argument, -1 if invalid
+static int parse_arg(const string& arg) {
+	try {
+		size_t end;
+		int val = stoi(arg, &end);
+		if (end != arg.length() || val < 0) {
+			return -1;
+		}
+		return val;
+	}
+	catch (const std::exception& e) {
+		return -1;
+	}
+}
+
+//Name of a move result in responses
+static string result_name(MoveResult res) {
+	switch (res) {
+	case WIN:
+		return "win";
+	case LOSS:
+		return "loss";
+	case GUESS_REQUIRED:
+		return "guess_required";
+	default:
+		return "continue";
+	}
+}
+
+//Histogram bucket of a latency in microseconds
+static int latency_bucket(double micros) {
+	if (micros < 1) {
+		return 0;
+	}
+	return min(LATENCY_BUCKETS - 1, (int)(log2(micros) * LATENCY_BUCKETS_PER_DOUBLING));
+}
+
+//Latency at the given fraction of the requests, as the upper bound of its histogram bucket (at most the largest latency)
+static double percentile(const LatencyStats& stats, double fraction) {
+	if (stats.count == 0) {
+		return 0;
+	}
+	long long rank = (long long)(fraction * (stats.count - 1) + 0.5) + 1;
+	long long seen = 0;
+	for (int b = 0; b < LATENCY_BUCKETS; b++) {
+		seen += stats.buckets[b];
+		if (seen >= rank) {
+			return min(stats.max, pow(2.0, (double)(b + 1) / LATENCY_BUCKETS_PER_DOUBLING));
+		}
+	}
+	return stats.max;
+}
+
+//Initialization with default bot settings, workers are started by run
+GameServer::GameServer(int num_workers) {
+	MAX_SIZE = 10;
+	subset_approximation = true;
+	edge_reduction = false;
+	model_counting = false;
+	endgame_squares = 0;
+	endgame_mines = 0;
+	lookahead_candidates = 0;
+	lookahead_time = 0;
+	time_budget = 0;
+	sample_budget = 0;
+	node_budget = SECTIONED_NODE_BUDGET;
+	memory_budget = SECTIONED_MEMORY_BUDGET;
+	cost_model = nullptr;
+	move_target = 0;
+	next_id = 1;
+	boards_created = 0;
+	boards_reused = 0;
+	rng.seed((unsigned)time(NULL));
+	m_workers = max(num_workers, 1);
+	closing = false;
+	output = nullptr;
+	start = chrono::steady_clock::now();
+}
+
+//Cleanup of all open and idle boards
+GameServer::~GameServer() {
+	{
+		lock_guard<mutex> guard(queue_lock);
+		closing = true;
+	}
+	queue_ready.notify_all();
+	for (thread& t : workers) {
+		t.join();
+	}
+	for (auto& entry : games) {
+		delete entry.second->board;
+	}
+	for (auto& entry : pool) {
+		for (Board* board : entry.second) {
+			delete board;
+		}
+	}
+}
+
+//Set maximum edge length of each game's bot
+void GameServer::set_edge_search_limit(int size) {
+	MAX_SIZE = size;
+}
+
+//Enable/disable approximation of each game's bot
+void GameServer::set_edge_subset_approximation(bool approximate) {
+	subset_approximation = approximate;
+}
+
+//Enable/disable reduction of edge constraints by each game's bot
+void GameServer::set_edge_reduction(bool reduce) {
+	edge_reduction = reduce;
+}
+
+//Enable/disable exact counting of large edges by each game's bot
+void GameServer::set_model_counting(bool count) {
+	model_counting = count;
+}
+
+//Set when each game's bot solves the whole board exactly
+void GameServer::set_endgame_thresholds(int squares, int mines) {
+	endgame_squares = squares;
+	endgame_mines = mines;
+}
+
+//Set number of guesses compared by each game's bot, and time allowed for comparing them in milliseconds
+void GameServer::set_lookahead(int candidates, double milliseconds) {
+	lookahead_candidates = candidates;
+	lookahead_time = milliseconds;
+}
+
+//Set time allowed for each bot move in milliseconds (0 for no limit)
+void GameServer::set_move_time_budget(double milliseconds) {
+	time_budget = milliseconds;
+}
+
+//Set number of samples used for large edges (0 to disable sampling)
+void GameServer::set_sample_budget(int samples) {
+	sample_budget = samples;
+}
+
+//Set node and memory budgets of each game's sub-edge trees (0 for no limit)
+void GameServer::set_sectioned_budget(int nodes, int megabytes) {
+	node_budget = nodes;
+	memory_budget = megabytes;
+}
+
+//Set cost model shared by every game's bot, and the time aimed for per move in milliseconds (0 to only record search times)
+void GameServer::set_cost_model(CostModel* model, double target_milliseconds) {
+	cost_model = model;
+	move_target = target_milliseconds;
+}
+
+//Read requests line by line, queueing each for the workers, and wait for all responses once the input closes
+//Responses may be written out of order, so each carries the tag of its request
+void GameServer::run(istream& in, ostream& out) {
+	output = &out;
+	closing = false;
+	for (int i = 0; i < m_workers; i++) {
+		workers.push_back(thread(&GameServer::worker, this));
+	}
+
+	string line;
+	while (getline(in, line)) {
+		if (!line.empty() && line.back() == '\r') {
+			line.pop_back();
+		}
+		if (line.empty()) {
+			continue;
+		}
+		{
+			lock_guard<mutex> guard(queue_lock);
+			queue.push_back({ line, chrono::steady_clock::now() });
+		}
+		queue_ready.notify_one();
+	}
+
+	{
+		lock_guard<mutex> guard(queue_lock);
+		closing = true;
+	}
+	queue_ready.notify_all();
+	for (thread& t : workers) {
+		t.join();
+	}
+	workers.clear();
+}
+
+//Take requests from the queue until it is empty and the server is closing
+void GameServer::worker() {
+	while (true) {
+		ServerRequest request;
+		{
+			unique_lock<mutex> guard(queue_lock);
+			queue_ready.wait(guard, [this] { return closing || !queue.empty(); });
+			if (queue.empty()) {
+				return;
+			}
+			request = queue.front();
+			queue.pop_front();
+		}
+		respond(request, handle(request.line));
+	}
+}
+
+//Write the response and record the latency of the request from when it was read
+void GameServer::respond(const ServerRequest& request, const string& response) {
+	{
+		lock_guard<mutex> guard(output_lock);
+		*output << response << '\n';
+		output->flush();
+	}
+	double micros = chrono::duration<double, micro>(chrono::steady_clock::now() - request.received).count();
+
+	vector<string> words = split_words(request.line);
+	string command = words.size() > 1 ? words[1] : "invalid";
+	lock_guard<mutex> guard(stats_lock);
+	LatencyStats& stats = latencies[command];
+	stats.count += 1;
+	stats.total += micros;
+	stats.max = max(stats.max, micros);
+	stats.buckets[latency_bucket(micros)] += 1;
+	if (response.find(" error") != string::npos) {
+		stats.errors += 1;
+	}
+}
+
+//Answer a request of the form "<tag> <command> [args]", with a response of the form "<tag> ok [values]" or "<tag> error <message>"
+string GameServer::handle(const string& line) {
+	vector<string> words = split_words(line);
+	if (words.size() < 2) {
+		return (words.empty() ? "-" : words[0]) + " error missing command";
+	}
+	string tag = words[0];
+	string command = words[1];
+	vector<string> args(words.begin() + 2, words.end());
+
+	if (command == "new") {
+		return tag + new_game(args);
+	}
+	if (command == "stats") {
+		return tag + " ok " + get_stats();
+	}
+
+	//All other commands act on an open game
+	if (args.empty()) {
+		return tag + " error missing game";
+	}
+	int id = parse_arg(args[0]);
+	if (command == "close") {
+		return tag + close_game(id);
+	}
+	shared_ptr<ServerGame> game = find_game(id);
+	if (game == nullptr) {
+		return tag + " error unknown game";
+	}
+	lock_guard<mutex> guard(game->lock);
+	if (game->board == nullptr) { //Closed while waiting
+		return tag + " error unknown game";
+	}
+	if (command == "next") {
+		return tag + next_move(game.get());
+	}
+	if (command == "hint") {
+		return tag + hint(game.get());
+	}
+	if (command == "move") {
+		return tag + user_move(game.get(), args);
+	}
+	if (command == "reset") {
+		return tag + reset_game(game.get());
+	}
+	return tag + " error unknown command";
+}
+
+//Open a game with the given size (9x9 with 10 mines by default), responding with its id
+string GameServer::new_game(vector<string>& args) {
+	int rows = 9;
+	int cols = 9;
+	int mines = 10;
+	if (args.size() == 3) {
+		rows = parse_arg(args[0]);
+		cols = parse_arg(args[1]);
+		mines = parse_arg(args[2]);
+	}
+	else if (!args.empty()) {
+		return " error expected rows, columns and mines";
+	}
+	if (rows <= 0 || cols <= 0 || mines < 0 || mines >= rows * cols) {
+		return " error bad board size";
+	}
+
+	shared_ptr<ServerGame> game = make_shared<ServerGame>();
+	lock_guard<mutex> guard(game->lock); //Requests for the new game wait until its board is ready
+	game->board = nullptr;
+	int id;
+	{
+		lock_guard<mutex> games_guard(games_lock);
+		if (games.size() >= SERVER_MAX_GAMES) {
+			return " error too many games";
+		}
+		id = next_id++;
+		games[id] = game;
+	}
+	game->board = acquire_board(rows, cols, mines);
+	game->last_result = CONTINUE;
+	return " ok " + to_string(id);
+}
+
+//Let the bot play its next move
+string GameServer::next_move(ServerGame* game) {
+	if (game->last_result == WIN || game->last_result == LOSS) {
+		return " error game over";
+	}
+	game->last_result = game->board->get_bot()->select_next_move();
+	return " ok " + result_name(game->last_result);
+}
+
+//Suggest a move without making it: a square proven safe, or else the best guess with its probability of being a mine
+string GameServer::hint(ServerGame* game) {
+	if (game->last_result == WIN || game->last_result == LOSS) {
+		return " error game over";
+	}
+	Bot* bot = game->board->get_bot();
+	vector<pair<int, int>> safe = bot->get_safe_squares(); //Safe squares still queued by the last move, which analyze would clear
+	if (safe.empty()) {
+		bot->analyze();
+		safe = bot->get_safe_squares();
+	}
+	if (!safe.empty()) {
+		return " ok safe " + to_string(safe[0].first) + " " + to_string(safe[0].second);
+	}
+	vector<pair<int, int>> guesses = bot->get_best_guesses(1);
+	if (guesses.empty()) {
+		return " error no unknown squares";
+	}
+	pair<int, int> p = guesses[0];
+	return " ok guess " + to_string(p.first) + " " + to_string(p.second) + " " + to_string(bot->get_probability(p.first, p.second));
+}
+
+//Make the player's move at the given square
+string GameServer::user_move(ServerGame* game, vector<string>& args) {
+	if (game->last_result == WIN || game->last_result == LOSS) {
+		return " error game over";
+	}
+	if (args.size() != 3) {
+		return " error expected row and column";
+	}
+	Board* board = game->board;
+	int i = parse_arg(args[1]);
+	int j = parse_arg(args[2]);
+	if (i < 0 || j < 0 || i >= board->get_rows() || j >= board->get_cols()) {
+		return " error bad square";
+	}
+	if (board->is_known(i, j)) {
+		return " error square already known";
+	}
+	game->last_result = board->make_move(i, j);
+	return " ok " + result_name(game->last_result);
+}
+
+//Start a new game of the same size on the game's board
+string GameServer::reset_game(ServerGame* game) {
+	Board* board = game->board;
+	string layout;
+	{
+		lock_guard<mutex> guard(pool_lock);
+		layout = random_layout(board->get_rows(), board->get_cols(), board->get_mines());
+	}
+	board->load_seed(layout);
+	game->last_result = CONTINUE;
+	return " ok";
+}
+
+//Close the game once any request in progress on it is done, returning its board to the pool
+string GameServer::close_game(int id) {
+	shared_ptr<ServerGame> game;
+	{
+		lock_guard<mutex> guard(games_lock);
+		unordered_map<int, shared_ptr<ServerGame>>::iterator it = games.find(id);
+		if (it == games.end()) {
+			return " error unknown game";
+		}
+		game = it->second;
+		games.erase(it);
+	}
+	lock_guard<mutex> guard(game->lock);
+	release_board(game->board);
+	game->board = nullptr;
+	return " ok";
+}
+
+//Get an open game, nullptr if there is none with the given id
+shared_ptr<ServerGame> GameServer::find_game(int id) {
+	lock_guard<mutex> guard(games_lock);
+	unordered_map<int, shared_ptr<ServerGame>>::iterator it = games.find(id);
+	if (it == games.end()) {
+		return nullptr;
+	}
+	return it->second;
+}
+
+//Take an idle board of the given size from the pool and start a new game on it, creating a board if there are none
+Board* GameServer::acquire_board(int rows, int cols, int mines) {
+	Board* board = nullptr;
+	string layout;
+	{
+		lock_guard<mutex> guard(pool_lock);
+		layout = random_layout(rows, cols, mines);
+		vector<Board*>& idle = pool[{ rows, cols, mines }];
+		if (!idle.empty()) {
+			board = idle.back();
+			idle.pop_back();
+			boards_reused += 1;
+		}
+		else {
+			boards_created += 1;
+		}
+	}
+	if (board == nullptr) {
+		board = new Board(rows, cols, mines, Board::compress_seed(layout), false);
+	}
+	else {
+		board->load_seed(layout);
+	}
+	configure(board);
+	return board;
+}
+
+//Return a board to the pool for reuse, deleting it if enough boards of its size are already idle
+void GameServer::release_board(Board* board) {
+	{
+		lock_guard<mutex> guard(pool_lock);
+		vector<Board*>& idle = pool[{ board->get_rows(), board->get_cols(), board->get_mines() }];
+		if (idle.size() < SERVER_POOL_SIZE) {
+			idle.push_back(board);
+			return;
+		}
+	}
+	delete board;
+}
+
+//Generate uncompressed seed with mines placed uniformly, keeping the first square free like a new terminal game
+//Called with the pool lock held, which also guards the random number generator
+string GameServer::random_layout(int rows, int cols, int mines) {
+	string seed(rows * cols, '0');
+	vector<int> candidates(rows * cols - 1);
+	for (int k = 0; k < candidates.size(); k++) {
+		candidates[k] = k + 1;
+	}
+	for (int k = 0; k < mines; k++) { //Partial Fisher-Yates shuffle
+		uniform_int_distribution<int> dist(k, candidates.size() - 1);
+		swap(candidates[k], candidates[dist(rng)]);
+		seed[candidates[k]] = '1';
+	}
+	return seed;
+}
+
+//Apply the server's settings to the bot of a board
+void GameServer::configure(Board* board) {
+	Bot* bot = board->get_bot();
+	bot->set_edge_search_limit(MAX_SIZE);
+	bot->set_edge_subset_approximation(subset_approximation);
+	bot->set_edge_reduction(edge_reduction);
+	bot->set_model_counting(model_counting);
+	bot->set_endgame_thresholds(endgame_squares, endgame_mines);
+	bot->set_lookahead(lookahead_candidates, lookahead_time);
+	bot->set_move_time_budget(time_budget);
+	bot->set_sample_budget(sample_budget);
+	bot->set_sectioned_budget(node_budget, memory_budget);
+	bot->set_cost_model(cost_model, move_target);
+}
+
+//Summary of the server on one line: open games, board reuse, and count, errors and latency percentiles in microseconds of each command
+string GameServer::get_stats() {
+	ostringstream out;
+	double uptime = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+	out << "uptime " << uptime << " games " << get_open_games();
+	{
+		lock_guard<mutex> guard(pool_lock);
+		out << " boards_created " << boards_created << " boards_reused " << boards_reused;
+	}
+	lock_guard<mutex> guard(stats_lock);
+	for (auto& entry : latencies) {
+		LatencyStats& stats = entry.second;
+		out << " " << entry.first << " count=" << stats.count << ",errors=" << stats.errors;
+		out << ",mean=" << (stats.count == 0 ? 0 : stats.total / stats.count);
+		out << ",p50=" << percentile(stats, 0.5) << ",p99=" << percentile(stats, 0.99) << ",max=" << stats.max;
+	}
+	return out.str();
+}
+
+//Number of games currently open
+int GameServer::get_open_games() {
+	lock_guard<mutex> guard(games_lock);
+	return games.size();
+}
@@ -0,0 +1,141 @@
+#ifndef SERVER_H
+#define SERVER_H
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <map>
+#include <unordered_map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <chrono>
+#include <random>
+#include <iostream>
+#include "util.h"
+#include "cost_model.h"
+
+#define SERVER_MAX_GAMES 100000 //Maximum number of games open at once
+#define SERVER_POOL_SIZE 1024 //Maximum number of idle boards kept for reuse per board size
+#define LATENCY_BUCKETS_PER_DOUBLING 8 //Latency histogram resolution, about 9% between bucket bounds
+#define LATENCY_BUCKETS (32 * LATENCY_BUCKETS_PER_DOUBLING) //Latencies up to 2^32 microseconds, longer ones share the last bucket
+
+class Board;
+
+struct ServerRequest { //One line of the protocol, timed from when it was read
+	std::string line;
+	std::chrono::steady_clock::time_point received;
+};
+
+struct ServerGame { //Open game, locked while a worker handles one of its requests
+	Board* board;
+	MoveResult last_result;
+	std::mutex lock;
+};
+
+struct LatencyStats { //Latency in microseconds of all requests of one command, as a histogram of fixed size however many requests are made
+	long long count = 0;
+	int errors = 0;
+	double total = 0;
+	double max = 0;
+	long long buckets[LATENCY_BUCKETS] = {}; //Requests by latency, LATENCY_BUCKETS_PER_DOUBLING buckets per power of two microseconds
+};
+
+//Hosts many games at once over a line-delimited protocol, each request answered by a pool of worker threads
+//Boards (and their bots) of closed games are kept per size and reused for new games
+class GameServer {
+public:
+	//Initialization and cleanup
+	GameServer(int num_workers);
+	~GameServer();
+
+	//Settings applied to the bot of every game
+	void set_edge_search_limit(int size);
+	void set_edge_subset_approximation(bool approximate);
+	void set_edge_reduction(bool reduce);
+	void set_model_counting(bool count);
+	void set_endgame_thresholds(int squares, int mines);
+	void set_lookahead(int candidates, double milliseconds);
+	void set_move_time_budget(double milliseconds);
+	void set_sample_budget(int samples);
+	void set_sectioned_budget(int nodes, int megabytes);
+	void set_cost_model(CostModel* model, double target_milliseconds);
+
+	//Key method: answer requests from the input until it closes
+	void run(std::istream& in, std::ostream& out);
+
+	//Answer a single request
+	std::string handle(const std::string& line);
+
+	//Stats
+	std::string get_stats();
+	int get_open_games();
+
+private:
+	//Worker threads
+	void worker();
+	void respond(const ServerRequest& request, const std::string& response);
+
+	//Commands
+	std::string new_game(std::vector<std::string>& args);
+	std::string next_move(ServerGame* game);
+	std::string hint(ServerGame* game);
+	std::string user_move(ServerGame* game, std::vector<std::string>& args);
+	std::string reset_game(ServerGame* game);
+	std::string close_game(int id);
+	std::shared_ptr<ServerGame> find_game(int id);
+
+	//Board pool
+	Board* acquire_board(int rows, int cols, int mines);
+	void release_board(Board* board);
+	std::string random_layout(int rows, int cols, int mines);
+	void configure(Board* board);
+
+	//Settings
+	int MAX_SIZE;
+	bool subset_approximation;
+	bool edge_reduction;
+	bool model_counting;
+	int endgame_squares;
+	int endgame_mines;
+	int lookahead_candidates;
+	double lookahead_time;
+	double time_budget;
+	int sample_budget;
+	int node_budget;
+	int memory_budget;
+	CostModel* cost_model; //Shared by every game's bot
+	double move_target;
+
+	//Open games
+	std::unordered_map<int, std::shared_ptr<ServerGame>> games;
+	int next_id;
+	std::mutex games_lock;
+
+	//Idle boards by number of rows, columns and mines
+	std::map<std::vector<int>, std::vector<Board*>> pool;
+	int boards_created;
+	int boards_reused;
+	std::mt19937 rng;
+	std::mutex pool_lock;
+
+	//Requests waiting for a worker
+	std::deque<ServerRequest> queue;
+	std::vector<std::thread> workers;
+	int m_workers;
+	bool closing;
+	std::mutex queue_lock;
+	std::condition_variable queue_ready;
+
+	//Responses
+	std::ostream* output;
+	std::mutex output_lock;
+
+	//Latency of each command
+	std::map<std::string, LatencyStats> latencies;
+	std::chrono::steady_clock::time_point start;
+	std::mutex stats_lock;
+};
+
+#endif //SERVER_H
@@ -0,0 +1,264 @@
+#include "shard_runner.h"
+#include "board.h"
+#include "bot.h"
+#include <iostream>
+#include <fstream>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include <stdio.h>
+#include <csignal>
+#ifndef _WIN32
+#include <unistd.h>
+#include <sys/wait.h>
+#endif
+
+using namespace std;
+
+//Initialization, splitting the games evenly between the shards
+ShardRunner::ShardRunner(int num_shards, long long num_games, unsigned long long run_seed, string stats_prefix)
+	: m_shards(num_shards), m_games(num_games), m_seed(run_seed), m_prefix(stats_prefix)
+{
+	total = ShardStats();
+	elapsed = 0;
+}
+
+//Path of the stats file of a shard
+string ShardRunner::stats_path(int shard) {
+	return m_prefix + "." + to_string(shard);
+}
+
+//Uncompressed layout of a game, with mines placed uniformly (never on the opening square) by a generator seeded with the run's seed and the game's index
+string ShardRunner::game_layout(int rows, int cols, int mines, unsigned long long run_seed, long long game) {
+	mt19937_64 rng(mix_hash(mix_hash(run_seed) + game));
+	string layout(rows * cols, '0');
+	vector<int> candidates;
+	for (int k = 1; k < rows * cols; k++) {
+		candidates.push_back(k);
+	}
+	for (int k = 0; k < mines; k++) { //Partial Fisher-Yates shuffle
+		uniform_int_distribution<int> dist(k, candidates.size() - 1);
+		swap(candidates[k], candidates[dist(rng)]);
+		layout[candidates[k]] = '1';
+	}
+	return layout;
+}
+
+//Play the games of each shard in its own process, starting another process after any crash, then merge the shards' stats
+bool ShardRunner::run(Board* board) {
+#ifdef _WIN32
+	cout << "Sharded simulation needs fork, which is only available on Linux and other Unix systems" << endl;
+	return false;
+#else
+	int rows = board->get_rows();
+	int cols = board->get_cols();
+	int mines = board->get_mines();
+	unsigned long long settings = board->get_bot()->get_settings_hash();
+	if (mines >= rows * cols) {
+		cout << "Error: bad number of mines" << endl;
+		return false;
+	}
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	board->set_verbose(false);
+
+	bool ok = true;
+	shards.clear();
+	for (int k = 0; k < m_shards; k++) {
+		ShardStats stats = ShardStats();
+		stats.magic = SHARD_MAGIC;
+		stats.rows = rows;
+		stats.cols = cols;
+		stats.mines = mines;
+		stats.run_seed = m_seed;
+		stats.settings = settings;
+		stats.first_game = m_games * k / m_shards;
+		stats.end_game = m_games * (k + 1) / m_shards;
+		stats.next_game = stats.first_game;
+		ShardStats previous;
+		if (load(stats_path(k), &previous) && previous.rows == rows && previous.cols == cols && previous.mines == mines && previous.run_seed == m_seed
+			&& previous.settings == settings && previous.first_game == stats.first_game && previous.end_game == stats.end_game) { //Same range of the same run with the same settings
+			if (previous.next_game >= previous.end_game) {
+				cout << "Shard " << k << " already played games " << previous.first_game << " to " << previous.end_game - 1 << ", reusing its stats from " << stats_path(k) << endl;
+			}
+			else if (previous.next_game > previous.first_game) {
+				cout << "Shard " << k << " continuing from game " << previous.next_game << endl;
+			}
+			stats = previous;
+		}
+		else if (!save(stats, stats_path(k))) {
+			cout << "Could not write shard stats to " << stats_path(k) << endl;
+			return false;
+		}
+		shards.push_back(stats);
+	}
+
+	vector<int> pids(m_shards, -1);
+	int running = 0;
+	for (int k = 0; k < m_shards; k++) {
+		if (shards[k].next_game < shards[k].end_game && start_shard(board, k, &pids)) {
+			running += 1;
+		}
+	}
+	while (running > 0) {
+		int status;
+		int pid = waitpid(-1, &status, 0);
+		if (pid < 0) { //Interrupted, or no processes left
+			break;
+		}
+		int k = find(pids.begin(), pids.end(), pid) - pids.begin();
+		if (k == m_shards) {
+			continue;
+		}
+		pids[k] = -1;
+		running -= 1;
+
+		ShardStats& stats = shards[k];
+		if (WIFSIGNALED(status) && WTERMSIG(status) == SIGINT) { //Interrupted along with this process, left for the next run to continue
+			load(stats_path(k), &stats);
+			continue;
+		}
+		if ((WIFEXITED(status) && WEXITSTATUS(status) == SHARD_EXIT_IO) || !load(stats_path(k), &stats)) {
+			cout << "Shard " << k << " could not write its stats to " << stats_path(k) << endl;
+			ok = false;
+			continue;
+		}
+		if (!(WIFEXITED(status) && WEXITSTATUS(status) == 0) && stats.next_game < stats.end_game) { //Crashed on its next game, skip it
+			cout << "Game " << stats.next_game << " crashed (seed " << Board::compress_seed(game_layout(rows, cols, mines, m_seed, stats.next_game)) << "), continuing after it" << endl;
+			stats.crashes += 1;
+			stats.next_game += 1;
+			if (!save(stats, stats_path(k))) {
+				cout << "Could not write shard stats to " << stats_path(k) << endl;
+				ok = false;
+				continue;
+			}
+		}
+		if (stats.next_game < stats.end_game && start_shard(board, k, &pids)) {
+			running += 1;
+		}
+	}
+
+	total = ShardStats();
+	for (ShardStats& stats : shards) {
+		merge(stats, &total);
+	}
+	elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+	return ok;
+#endif
+}
+
+//Fork a process playing the rest of the shard's range, returns false if it cannot be started
+bool ShardRunner::start_shard(Board* board, int shard, vector<int>* pids) {
+#ifdef _WIN32
+	return false;
+#else
+	cout.flush(); //Output buffered before the fork would be written by both processes
+	int pid = fork();
+	if (pid < 0) {
+		cout << "Could not start shard " << shard << endl;
+		return false;
+	}
+	if (pid == 0) {
+		play_shard(board, shard);
+	}
+	(*pids)[shard] = pid;
+	return true;
+#endif
+}
+
+//Play the rest of the shard's range in this (forked) process, saving its stats after each game, and exit
+void ShardRunner::play_shard(Board* board, int shard) {
+#ifndef _WIN32
+	signal(SIGINT, SIG_DFL); //Interrupted with the main process, which cleans up alone
+	ShardStats stats = shards[shard];
+	string path = stats_path(shard);
+	Bot* bot = board->get_bot();
+	for (long long game = stats.next_game; game < stats.end_game; game++) {
+		board->load_seed(game_layout(stats.rows, stats.cols, stats.mines, m_seed, game));
+		bot->set_random_seed((unsigned)mix_hash(m_seed + game));
+		MoveResult res;
+		do {
+			res = bot->select_next_move();
+		} while (res == CONTINUE);
+
+		GameStats game_stats = bot->get_game_stats();
+		stats.games += 1;
+		stats.wins += res == WIN;
+		stats.moves += game_stats.moves;
+		stats.guesses += game_stats.guesses;
+		if (res == LOSS) {
+			stats.losses_by_guesses[min(game_stats.guesses, SHARD_GUESS_BUCKETS)] += 1;
+		}
+		stats.largest_edge = max(stats.largest_edge, game_stats.largest_edge);
+		stats.result_hash += mix_hash(mix_hash(game) ^ ((unsigned long long)game_stats.moves << 2 | res));
+		stats.next_game = game + 1;
+		if (!save(stats, path)) {
+			_exit(SHARD_EXIT_IO);
+		}
+	}
+	_exit(0);
+#endif
+}
+
+//Add the totals of a shard to the merged totals (independent of the order shards are merged in)
+void ShardRunner::merge(const ShardStats& shard, ShardStats* total) {
+	total->games += shard.games;
+	total->wins += shard.wins;
+	total->crashes += shard.crashes;
+	total->moves += shard.moves;
+	total->guesses += shard.guesses;
+	for (int k = 0; k <= SHARD_GUESS_BUCKETS; k++) {
+		total->losses_by_guesses[k] += shard.losses_by_guesses[k];
+	}
+	total->largest_edge = max(total->largest_edge, shard.largest_edge);
+	total->result_hash += shard.result_hash;
+}
+
+//Write a shard's stats to a temporary file and move it over the last stats, so a crash never leaves them half written
+bool ShardRunner::save(const ShardStats& stats, string path) {
+	string temp = path + ".tmp";
+	{
+		ofstream out(temp, ios::binary);
+		if (!out) {
+			return false;
+		}
+		out.write((const char*)&stats, sizeof(ShardStats));
+		if (!out.good()) {
+			return false;
+		}
+	}
+	return rename(temp.c_str(), path.c_str()) == 0;
+}
+
+//Read a shard's stats written by save, returns false if the file is missing or not a stats file
+bool ShardRunner::load(string path, ShardStats* stats) {
+	ifstream in(path, ios::binary);
+	if (!in) {
+		return false;
+	}
+	ShardStats read;
+	in.read((char*)&read, sizeof(ShardStats));
+	if (!in.good() || read.magic != SHARD_MAGIC) {
+		return false;
+	}
+	*stats = read;
+	return true;
+}
+
+//Print out the merged stats of the last run
+void ShardRunner::print_stats() {
+	cout << "Played " << total.games << " games on " << m_shards << " processes in " << elapsed << " seconds" << endl;
+	if (total.games == 0) {
+		return;
+	}
+	cout << "Won: " << total.wins << " (" << 100.0 * total.wins / total.games << "%)" << endl;
+	cout << "Crashed: " << total.crashes << endl;
+	cout << "Moves per game: " << (double)total.moves / total.games << ", guesses per game: " << (double)total.guesses / total.games << endl;
+	cout << "Losses by number of guesses made:" << endl;
+	for (int k = 0; k <= SHARD_GUESS_BUCKETS; k++) {
+		if (total.losses_by_guesses[k] > 0) {
+			cout << "\t" << k << (k == SHARD_GUESS_BUCKETS ? "+" : "") << ": " << total.losses_by_guesses[k] << endl;
+		}
+	}
+	cout << "Largest edge: " << total.largest_edge << " squares" << endl;
+	cout << "Result hash: " << total.result_hash << endl;
+}
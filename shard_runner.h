@@ -0,0 +1,74 @@
+#ifndef SHARD_RUNNER_H
+#define SHARD_RUNNER_H
+
+#include <string>
+#include <vector>
+#include "util.h"
+
+#define SHARD_MAGIC 0x5453534d //"MSST" at the start of every shard stats file
+#define SHARD_GUESS_BUCKETS 10 //Losses on this many guesses or more share the last bucket
+#define SHARD_EXIT_IO 3 //Exit code of a shard process that could not write its stats
+
+class Board;
+
+struct ShardStats { //Totals of a range of games, added up exactly when merged
+	int magic;
+	int rows;
+	int cols;
+	int mines;
+	unsigned long long run_seed;
+	unsigned long long settings; //Hash of the bot's settings
+	long long first_game;
+	long long end_game;
+	long long next_game; //First game of the range not played yet
+	long long games;
+	long long wins;
+	long long crashes; //Games whose process crashed, skipped
+	long long moves;
+	long long guesses;
+	long long losses_by_guesses[SHARD_GUESS_BUCKETS + 1];
+	int largest_edge;
+	unsigned long long result_hash; //Sum of a hash of each game's index, result and moves, the same however the games are split
+};
+
+//Plays games 0 to num_games - 1 of a run in several processes forked from this one, each playing its own range of games
+//The layout of each game only depends on the run's seed and the game's index, and the bot is reset and reseeded before each game,
+//so each game plays the same in any process. Each process rewrites the stats of its range to its own file after every game.
+//When a process crashes, its game is counted as a crash and a new process continues the range after it from the file,
+//and the stats of the ranges are then merged, giving the same totals as playing every game in one process
+class ShardRunner {
+public:
+	//Initialization
+	ShardRunner(int num_shards, long long num_games, unsigned long long run_seed, std::string stats_prefix);
+
+	//Key method: play every game on the board's bot in the shard processes and merge their stats, returns false if a shard could not write its stats
+	//Ranges of a previous run with the same settings whose stats files are still there continue where they stopped
+	bool run(Board* board);
+
+	//Merging
+	static void merge(const ShardStats& shard, ShardStats* total);
+	void print_stats();
+
+	//Stats files
+	static bool save(const ShardStats& stats, std::string path);
+	static bool load(std::string path, ShardStats* stats);
+
+	//Uncompressed layout of a game of the run
+	static std::string game_layout(int rows, int cols, int mines, unsigned long long run_seed, long long game);
+
+private:
+	void play_shard(Board* board, int shard);
+	bool start_shard(Board* board, int shard, std::vector<int>* pids);
+	std::string stats_path(int shard);
+
+	int m_shards;
+	long long m_games;
+	unsigned long long m_seed;
+	std::string m_prefix;
+
+	std::vector<ShardStats> shards;
+	ShardStats total;
+	double elapsed;
+};
+
+#endif //SHARD_RUNNER_H
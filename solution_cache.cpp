@@ -0,0 +1,193 @@
+#include "solution_cache.h"
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+
+using namespace std;
+
+//Rotations and reflections of the board, as multipliers for (row, column) to (row, column)
+const static int TRANSFORMS[8][4]{
+	{1,0,0,1},
+	{0,1,-1,0},
+	{-1,0,0,-1},
+	{0,-1,1,0},
+	{1,0,0,-1},
+	{-1,0,0,1},
+	{0,1,1,0},
+	{0,-1,-1,0}
+};
+
+struct PatternItem { //Square or constraint of an edge after a transform
+	int row;
+	int col;
+	int value; //Remaining count for constraints, -1 for squares
+	int index; //Index in original squares vector
+};
+
+//Constructor
+SolutionCache::SolutionCache(int capacity)
+	: m_capacity(capacity)
+{
+	hits = 0;
+	misses = 0;
+	evictions = 0;
+}
+
+//Encode the structure of an edge (its squares and its constraints with remaining counts) as a string
+//Each of the 8 rotations and reflections is translated to the origin and sorted, and the smallest encoding is used
+//Fills order with the index of each square in canonical order
+string SolutionCache::canonical_key(vector<pair<int, int>>& squares, vector<pair<pair<int, int>, int>>& constraints, vector<int>* order) {
+	string best;
+	vector<PatternItem> items(squares.size() + constraints.size());
+	for (int t = 0; t < 8; t++) {
+		int min_row = 0;
+		int min_col = 0;
+		for (int k = 0; k < items.size(); k++) { //Transform each square and constraint
+			pair<int, int> p = k < squares.size() ? squares[k] : constraints[k - squares.size()].first;
+			items[k].row = TRANSFORMS[t][0] * p.first + TRANSFORMS[t][1] * p.second;
+			items[k].col = TRANSFORMS[t][2] * p.first + TRANSFORMS[t][3] * p.second;
+			items[k].value = k < squares.size() ? -1 : constraints[k - squares.size()].second;
+			items[k].index = k;
+			if (k == 0 || items[k].row < min_row) {
+				min_row = items[k].row;
+			}
+			if (k == 0 || items[k].col < min_col) {
+				min_col = items[k].col;
+			}
+		}
+		sort(items.begin(), items.end(), [](const PatternItem& a, const PatternItem& b) {
+			return a.row < b.row || (a.row == b.row && a.col < b.col);
+		});
+
+		string key;
+		for (PatternItem item : items) { //Two bytes per coordinate, one for the value
+			int r = item.row - min_row;
+			int c = item.col - min_col;
+			key += (char)(r >> 8);
+			key += (char)(r & 255);
+			key += (char)(c >> 8);
+			key += (char)(c & 255);
+			key += (char)(item.value + 1);
+		}
+		if (t == 0 || key < best) {
+			best = key;
+			order->clear();
+			for (PatternItem item : items) {
+				if (item.value == -1) {
+					order->push_back(item.index);
+				}
+			}
+		}
+	}
+	return best;
+}
+
+//Find cached pattern, marking it as most recently used
+bool SolutionCache::lookup(const string& key, CachedPattern* pattern) {
+	lock_guard<mutex> guard(m_lock);
+	unordered_map<string, list<pair<string, CachedPattern>>::iterator>::iterator itr = index.find(key);
+	if (itr == index.end()) {
+		misses += 1;
+		return false;
+	}
+	hits += 1;
+	entries.splice(entries.begin(), entries, itr->second);
+	*pattern = itr->second->second;
+	return true;
+}
+
+//Insert pattern, evicting the least recently used pattern if the cache is full
+void SolutionCache::insert(const string& key, const CachedPattern& pattern) {
+	lock_guard<mutex> guard(m_lock);
+	if (index.find(key) != index.end()) {
+		return;
+	}
+	entries.push_front(make_pair(key, pattern));
+	index[key] = entries.begin();
+	if (entries.size() > m_capacity) {
+		index.erase(entries.back().first);
+		entries.pop_back();
+		evictions += 1;
+	}
+}
+
+//Write all patterns to a binary file, least recently used first
+bool SolutionCache::save(string path) {
+	lock_guard<mutex> guard(m_lock);
+	ofstream out(path, ios::binary);
+	if (!out) {
+		return false;
+	}
+	int count = entries.size();
+	out.write((char*)&count, sizeof(int));
+	for (list<pair<string, CachedPattern>>::reverse_iterator itr = entries.rbegin(); itr != entries.rend(); itr++) {
+		int key_size = itr->first.size();
+		int squares = itr->second.square_counts.size();
+		int mines = itr->second.histogram.size();
+		out.write((char*)&key_size, sizeof(int));
+		out.write(itr->first.data(), key_size);
+		out.write((char*)&squares, sizeof(int));
+		out.write((char*)itr->second.square_counts.data(), squares * sizeof(double));
+		out.write((char*)&mines, sizeof(int));
+		out.write((char*)itr->second.histogram.data(), mines * sizeof(double));
+	}
+	return out.good();
+}
+
+//Read patterns from a binary file written by save
+//Sizes are checked before anything is allocated, so a truncated or corrupt file stops the load (keeping the patterns read before it)
+bool SolutionCache::load(string path) {
+	ifstream in(path, ios::binary);
+	if (!in) {
+		return false;
+	}
+	int count = 0;
+	in.read((char*)&count, sizeof(int));
+	if (!in.good() || count < 0) {
+		return false;
+	}
+	for (int i = 0; i < count; i++) {
+		int key_size = 0;
+		int squares = 0;
+		int mines = 0;
+		in.read((char*)&key_size, sizeof(int));
+		if (!in.good() || key_size <= 0 || key_size > PATTERN_CACHE_MAX_KEY) {
+			return false;
+		}
+		string key(key_size, '\0');
+		in.read(&key[0], key_size);
+		CachedPattern pattern;
+		in.read((char*)&squares, sizeof(int));
+		if (!in.good() || squares <= 0 || squares > PATTERN_CACHE_MAX_SQUARES) {
+			return false;
+		}
+		pattern.square_counts.resize(squares);
+		in.read((char*)pattern.square_counts.data(), squares * sizeof(double));
+		in.read((char*)&mines, sizeof(int));
+		if (!in.good() || mines < 0 || mines > squares + 1) {
+			return false;
+		}
+		pattern.histogram.resize(mines);
+		in.read((char*)pattern.histogram.data(), mines * sizeof(double));
+		if (!in.good()) {
+			return false;
+		}
+		insert(key, pattern);
+	}
+	return true;
+}
+
+//Print out hit rate and size of the cache
+void SolutionCache::print_stats() {
+	lock_guard<mutex> guard(m_lock);
+	cout << "Pattern cache: " << entries.size() << " patterns, " << hits << " hits, " << misses << " misses (" << (hits + misses > 0 ? 100.0 * hits / (hits + misses) : 0) << "% hit rate), " << evictions << " evictions" << endl;
+}
+
+//Fraction of lookups that were hits
+double SolutionCache::get_hit_rate() {
+	lock_guard<mutex> guard(m_lock);
+	if (hits + misses == 0) {
+		return 0;
+	}
+	return (double)hits / (hits + misses);
+}
@@ -0,0 +1,52 @@
+#ifndef SOLUTION_CACHE_H
+#define SOLUTION_CACHE_H
+
+#include <string>
+#include <vector>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+#define PATTERN_CACHE_SIZE 65536
+#define PATTERN_CACHE_MAX_SQUARES 64 //Largest edge read from a cache file, any larger is taken as a corrupt file
+#define PATTERN_CACHE_MAX_KEY (5 * 9 * PATTERN_CACHE_MAX_SQUARES) //Five bytes per square or constraint, at most 8 constraints per square
+
+struct CachedPattern { //Precise search result of an edge, with squares in canonical order
+	std::vector<double> square_counts; //Number of possibilities with each square as a mine
+	std::vector<double> histogram; //Number of possibilities with each number of mines
+};
+
+//Bounded, thread-safe cache of precise edge solutions shared across games
+//Edges are keyed by their constraint structure, independent of position, rotation and reflection on the board
+class SolutionCache {
+public:
+	//Initialization
+	SolutionCache(int capacity);
+
+	//Key generation
+	static std::string canonical_key(std::vector<std::pair<int, int>>& squares, std::vector<std::pair<std::pair<int, int>, int>>& constraints, std::vector<int>* order);
+
+	//Cache access
+	bool lookup(const std::string& key, CachedPattern* pattern);
+	void insert(const std::string& key, const CachedPattern& pattern);
+
+	//Persistence
+	bool save(std::string path);
+	bool load(std::string path);
+
+	//Stats
+	void print_stats();
+	double get_hit_rate();
+
+private:
+	int m_capacity;
+	std::mutex m_lock;
+	std::list<std::pair<std::string, CachedPattern>> entries; //Most recently used first
+	std::unordered_map<std::string, std::list<std::pair<std::string, CachedPattern>>::iterator> index;
+
+	long long hits;
+	long long misses;
+	long long evictions;
+};
+
+#endif //SOLUTION_CACHE_H
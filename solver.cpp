@@ -0,0 +1,128 @@
+#include "solver.h"
+
+using namespace std;
+
+//Copy states of a view, keeping a pointer to its counts
+void SolverBoard::load(const SolverView& view) {
+	m_rows = view.rows;
+	m_cols = view.cols;
+	m_mines = view.mines;
+	m_states.assign(view.states, view.states + view.rows * view.cols);
+	m_counts = view.counts;
+	mines_marked = 0;
+	squares_revealed = 0;
+	for (State s : m_states) {
+		if (s == KNOWN_MINE) mines_marked++;
+		if (s == KNOWN_SAFE) squares_revealed++;
+	}
+}
+
+//Check if a view is a later position of the game last loaded (same size, and every known square still known)
+bool SolverBoard::continues(const SolverView& view) {
+	if (view.rows != m_rows || view.cols != m_cols || view.mines != m_mines) {
+		return false;
+	}
+	for (int k = 0; k < m_rows * m_cols; k++) {
+		if (m_states[k] == KNOWN_SAFE && view.states[k] != KNOWN_SAFE) {
+			return false;
+		}
+	}
+	return true;
+}
+
+//Accessors
+int SolverBoard::get_rows() {
+	return m_rows;
+}
+
+int SolverBoard::get_cols() {
+	return m_cols;
+}
+
+int SolverBoard::get_mines() {
+	return m_mines;
+}
+
+int SolverBoard::get_mines_marked() {
+	return mines_marked;
+}
+
+int SolverBoard::get_squares_revealed() {
+	return squares_revealed;
+}
+
+bool SolverBoard::is_known(int i, int j) {
+	return m_states[i * m_cols + j] == KNOWN_MINE || m_states[i * m_cols + j] == KNOWN_SAFE;
+}
+
+bool SolverBoard::is_safe(int i, int j) {
+	return m_states[i * m_cols + j] == KNOWN_SAFE;
+}
+
+bool SolverBoard::is_marked_mine(int i, int j) {
+	return m_states[i * m_cols + j] == KNOWN_MINE;
+}
+
+int SolverBoard::get_count(int i, int j) {
+	return m_counts[i * m_cols + j];
+}
+
+//The solver never reveals squares, safe squares are returned to the caller instead
+MoveResult SolverBoard::make_move(int i, int j) {
+	return CONTINUE;
+}
+
+//Mark mine on the solver's copy only
+void SolverBoard::mark_mine(int i, int j) {
+	m_states[i * m_cols + j] = KNOWN_MINE;
+	mines_marked++;
+}
+
+//Constructor for default values
+Solver::Solver() {
+	bot.set_verbose(false);
+	loaded = false;
+}
+
+Bot* Solver::get_bot() {
+	return &bot;
+}
+
+//Find squares proven safe or mines, and the probability of each square being a mine
+SolverResult Solver::solve(const SolverView& view) {
+	if (!loaded || !board.continues(view)) { //New game, start over
+		board.load(view);
+		bot.reset();
+		bot.set_board(&board);
+		loaded = true;
+	}
+	else {
+		board.load(view);
+	}
+	bot.analyze();
+
+	SolverResult result;
+	result.safe_squares = bot.get_safe_squares();
+	result.tier = bot.get_last_tier();
+	result.probabilities.assign(view.rows * view.cols, 0);
+	for (int i = 0; i < view.rows; i++) {
+		for (int j = 0; j < view.cols; j++) {
+			int k = i * view.cols + j;
+			if (board.is_marked_mine(i, j)) {
+				result.probabilities[k] = 1;
+				if (view.states[k] != KNOWN_MINE) {
+					result.mines.push_back(make_pair(i, j));
+				}
+			}
+			else if (!board.is_safe(i, j)) {
+				result.probabilities[k] = bot.get_probability(i, j);
+			}
+		}
+	}
+	for (pair<int, int> p : result.safe_squares) {
+		result.probabilities[p.first * view.cols + p.second] = 0;
+	}
+	vector<pair<int, int>> guesses = bot.get_best_guesses(1);
+	result.best_guess = guesses.empty() ? make_pair(-1, -1) : guesses[0];
+	return result;
+}
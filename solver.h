@@ -0,0 +1,71 @@
+#ifndef SOLVER_H
+#define SOLVER_H
+
+#include <vector>
+#include "util.h"
+#include "bot.h"
+#include "board_view.h"
+
+//Game in progress given to the solver, owned by the caller and never modified
+struct SolverView {
+	int rows;
+	int cols;
+	int mines; //Total number of mines on the board
+	const State* states; //State of each square in row-major order (KNOWN_SAFE and KNOWN_MINE are known, anything else is unknown)
+	const int* counts; //Number of adjacent mines of each square in row-major order (only read for KNOWN_SAFE squares)
+};
+
+struct SolverResult {
+	std::vector<std::pair<int, int>> safe_squares; //Unknown squares proven safe
+	std::vector<std::pair<int, int>> mines; //Unknown squares proven to be mines
+	std::vector<double> probabilities; //Probability of each square being a mine in row-major order (0 or 1 for known squares)
+	std::pair<int, int> best_guess; //Safest unknown square, (-1, -1) if there are none
+	SolverTier tier; //Search that produced the deductions (or the probabilities if there are none)
+};
+
+//Solver's own copy of a view, so the bot can mark mines without touching the caller's board
+class SolverBoard : public BoardView {
+public:
+	void load(const SolverView& view);
+	bool continues(const SolverView& view);
+
+	int get_rows();
+	int get_cols();
+	int get_mines();
+	int get_mines_marked();
+	int get_squares_revealed();
+	bool is_known(int i, int j);
+	bool is_safe(int i, int j);
+	bool is_marked_mine(int i, int j);
+	int get_count(int i, int j);
+	MoveResult make_move(int i, int j);
+	void mark_mine(int i, int j);
+
+private:
+	int m_rows = 0;
+	int m_cols = 0;
+	int m_mines = 0;
+	int mines_marked = 0;
+	int squares_revealed = 0;
+	std::vector<State> m_states;
+	const int* m_counts = nullptr;
+};
+
+//Solver without any console output or board of its own: given a view of a game, returns deductions and probabilities
+//Consecutive views of the same game reuse the solutions of unchanged edges
+class Solver {
+public:
+	Solver();
+
+	//Bot used for solving, for changing its settings
+	Bot* get_bot();
+
+	SolverResult solve(const SolverView& view);
+
+private:
+	SolverBoard board;
+	Bot bot;
+	bool loaded;
+};
+
+#endif //SOLVER_H
@@ -0,0 +1,135 @@
+#include "task_pool.h"
+
+using namespace std;
+
+thread_local TaskPool* current_pool = nullptr;
+thread_local int current_index = 0;
+
+//Start the worker threads, the thread calling run is the last of the given number
+TaskPool::TaskPool(int num_threads) {
+	queued = 0;
+	stopping = false;
+	for (int i = 0; i < num_threads; i++) {
+		queues.push_back(new TaskQueue);
+	}
+	for (int i = 0; i < num_threads - 1; i++) {
+		workers.push_back(thread(&TaskPool::work, this, i));
+	}
+}
+
+//Stop the worker threads once they finish their current task
+TaskPool::~TaskPool() {
+	{
+		lock_guard<mutex> guard(sleep_lock);
+		stopping = true;
+	}
+	wake.notify_all();
+	for (thread& t : workers) {
+		t.join();
+	}
+	for (TaskQueue* q : queues) {
+		delete q;
+	}
+}
+
+//Number of threads running tasks, including the thread calling run
+int TaskPool::get_threads() {
+	return queues.size();
+}
+
+//Index of the current thread, from 0 to get_threads() - 1 (threads outside the pool share the last index)
+int TaskPool::get_thread_index() {
+	return current_pool == this ? current_index : workers.size();
+}
+
+//Queue every task of the batch on this thread's queue, then work until all of them have finished
+void TaskPool::run(int num_tasks, const function<void(int)>& task) {
+	if (num_tasks <= 0) {
+		return;
+	}
+	if (workers.empty() || num_tasks == 1) {
+		for (int i = 0; i < num_tasks; i++) {
+			task(i);
+		}
+		return;
+	}
+	int index = get_thread_index();
+	TaskBatch batch;
+	batch.task = &task;
+	batch.remaining = num_tasks;
+	{
+		lock_guard<mutex> guard(queues[index]->lock);
+		for (int i = 0; i < num_tasks; i++) {
+			queues[index]->jobs.push_back({ &batch, i });
+		}
+	}
+	{
+		lock_guard<mutex> guard(sleep_lock);
+		queued += num_tasks;
+	}
+	wake.notify_all();
+
+	while (batch.remaining > 0) { //Run this or other batches' tasks until this batch is done
+		TaskJob job;
+		if (take(index, &job)) {
+			execute(job);
+			continue;
+		}
+		unique_lock<mutex> guard(sleep_lock); //Sleep until a task is queued or the last task of the batch finishes elsewhere
+		wake.wait(guard, [this, &batch] { return batch.remaining == 0 || queued > 0; });
+	}
+}
+
+//Take the newest job from the thread's own queue, or steal the oldest job from another queue
+bool TaskPool::take(int index, TaskJob* job) {
+	if (queued == 0) {
+		return false;
+	}
+	for (int k = 0; k < queues.size(); k++) {
+		TaskQueue* q = queues[(index + k) % queues.size()];
+		lock_guard<mutex> guard(q->lock);
+		if (q->jobs.empty()) {
+			continue;
+		}
+		if (k == 0) {
+			*job = q->jobs.back();
+			q->jobs.pop_back();
+		}
+		else {
+			*job = q->jobs.front();
+			q->jobs.pop_front();
+		}
+		queued -= 1;
+		return true;
+	}
+	return false;
+}
+
+//Run one task and count it off its batch, waking the thread waiting for the batch after its last task
+void TaskPool::execute(TaskJob job) {
+	(*job.batch->task)(job.index);
+	if (--job.batch->remaining == 0) { //The batch may be gone once this is seen, so only the pool is touched after it
+		{
+			lock_guard<mutex> guard(sleep_lock); //The waiting thread is either before checking the count or asleep
+		}
+		wake.notify_all();
+	}
+}
+
+//Worker loop: run tasks while there are any, otherwise sleep until more are queued
+void TaskPool::work(int index) {
+	current_pool = this;
+	current_index = index;
+	while (true) {
+		TaskJob job;
+		if (take(index, &job)) {
+			execute(job);
+			continue;
+		}
+		unique_lock<mutex> guard(sleep_lock);
+		wake.wait(guard, [this] { return stopping || queued > 0; });
+		if (stopping) {
+			return;
+		}
+	}
+}
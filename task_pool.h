@@ -0,0 +1,56 @@
+#ifndef TASK_POOL_H
+#define TASK_POOL_H
+
+#include <vector>
+#include <deque>
+#include <functional>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+
+struct TaskBatch { //Tasks queued by one call to run, counted down as they finish
+	const std::function<void(int)>* task;
+	std::atomic<int> remaining;
+};
+
+struct TaskJob { //One task of a batch
+	TaskBatch* batch;
+	int index;
+};
+
+struct TaskQueue { //Jobs of one thread, taken from the back by the thread itself and stolen from the front by the others
+	std::mutex lock;
+	std::deque<TaskJob> jobs;
+};
+
+//Work-stealing pool running batches of independent tasks of uneven size
+//Each thread queues its own batches and works through them from the back, idle threads steal from the front of the others' queues,
+//and a thread waiting for its batch runs other tasks meanwhile, so tasks can run batches of their own
+class TaskPool {
+public:
+	//Initialization and cleanup
+	TaskPool(int num_threads);
+	~TaskPool();
+
+	//Key method: run task(0) to task(num_tasks - 1), returning once all have finished
+	void run(int num_tasks, const std::function<void(int)>& task);
+
+	//Number of threads running tasks (including the calling thread), and the index of the current one
+	int get_threads();
+	int get_thread_index();
+
+private:
+	bool take(int index, TaskJob* job);
+	void execute(TaskJob job);
+	void work(int index);
+
+	std::vector<std::thread> workers;
+	std::vector<TaskQueue*> queues; //One per worker, then one for the threads outside the pool
+	std::atomic<int> queued;
+	std::mutex sleep_lock;
+	std::condition_variable wake;
+	bool stopping;
+};
+
+#endif //TASK_POOL_H
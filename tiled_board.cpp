@@ -0,0 +1,322 @@
+#include "tiled_board.h"
+#include <iostream>
+#include <random>
+#include <stack>
+#include <climits>
+
+using namespace std;
+
+//Constructs board with the given seed, with nothing generated until the first move
+TiledBoard::TiledBoard(long long rows, long long columns, long long num_mines, unsigned long long seed)
+	: m_rows(rows), m_cols(columns), m_mines(num_mines), m_seed(seed)
+{
+	tile_rows_count = (m_rows + TILE_SIZE - 1) / TILE_SIZE;
+	tile_cols_count = (m_cols + TILE_SIZE - 1) / TILE_SIZE;
+	if (m_mines < 0 || m_mines >= m_rows * m_cols || m_mines > LLONG_MAX / (m_rows * m_cols)) {
+		cout << "Error: bad number of mines" << endl;
+		m_mines = 0;
+	}
+	squares_revealed = 0;
+	mines_marked = 0;
+	move_count = 0;
+	active = true;
+
+	//The game starts from the top left corner, so the window starts around it
+	explored_top = 0;
+	explored_bottom = 0;
+	explored_left = 0;
+	explored_right = 0;
+	window_top = 0;
+	window_left = 0;
+	window_rows = 0;
+	window_cols = 0;
+	window_mines = 0;
+	m_bot.set_verbose(false);
+	update_window();
+}
+
+//Cleanup of all generated tiles
+TiledBoard::~TiledBoard() {
+	for (auto& entry : tiles) {
+		delete entry.second;
+	}
+}
+
+//Let the bot play its next move
+//The window is only grown between moves, as the bot's searches keep coordinates within the window for the whole move
+MoveResult TiledBoard::next_move() {
+	if (!active) {
+		return LOSS;
+	}
+	update_window();
+	return m_bot.select_next_move();
+}
+
+Bot* TiledBoard::get_bot() {
+	return &m_bot;
+}
+
+//Whole board accessors
+long long TiledBoard::get_total_rows() {
+	return m_rows;
+}
+
+long long TiledBoard::get_total_cols() {
+	return m_cols;
+}
+
+long long TiledBoard::get_total_mines() {
+	return m_mines;
+}
+
+long long TiledBoard::get_total_revealed() {
+	return squares_revealed;
+}
+
+//Number of tiles generated so far
+int TiledBoard::get_tiles() {
+	return tiles.size();
+}
+
+//Approximate bytes used by the generated tiles
+long long TiledBoard::get_memory() {
+	return (long long)tiles.size() * (sizeof(Tile) + 2 * TILE_SQUARES);
+}
+
+//Print out moves, explored area and memory use
+void TiledBoard::print_stats() {
+	cout << "Board: " << m_rows << "x" << m_cols << " with " << m_mines << " mines" << endl;
+	cout << "Moves: " << move_count << endl;
+	cout << "Squares revealed: " << squares_revealed << endl;
+	cout << "Mines marked: " << mines_marked << endl;
+	cout << "Explored area: rows " << explored_top << " to " << explored_bottom << ", columns " << explored_left << " to " << explored_right << endl;
+	cout << "Bot window: " << window_rows << "x" << window_cols << " at " << window_top << "," << window_left << " with " << window_mines << " mines" << endl;
+	cout << "Tiles generated: " << tiles.size() << " of " << tile_rows_count * tile_cols_count << " (" << get_memory() / 1024 << " KB)" << endl;
+}
+
+//Window accessors
+int TiledBoard::get_rows() {
+	return window_rows;
+}
+
+int TiledBoard::get_cols() {
+	return window_cols;
+}
+
+//Exact number of mines in the window, as every tile has a fixed share of the mines
+int TiledBoard::get_mines() {
+	return window_mines;
+}
+
+//All marked and revealed squares are inside the window
+int TiledBoard::get_mines_marked() {
+	return mines_marked;
+}
+
+int TiledBoard::get_squares_revealed() {
+	return squares_revealed;
+}
+
+bool TiledBoard::is_known(int i, int j) {
+	State s = get_state(window_top + i, window_left + j);
+	return s == KNOWN_MINE || s == KNOWN_SAFE;
+}
+
+bool TiledBoard::is_safe(int i, int j) {
+	return get_state(window_top + i, window_left + j) == KNOWN_SAFE;
+}
+
+bool TiledBoard::is_marked_mine(int i, int j) {
+	return get_state(window_top + i, window_left + j) == KNOWN_MINE;
+}
+
+//Only called for revealed squares, whose tiles always exist
+int TiledBoard::get_count(int i, int j) {
+	long long ai = window_top + i;
+	long long aj = window_left + j;
+	Tile* t = find_tile(ai / TILE_SIZE, aj / TILE_SIZE);
+	return t->counts[(ai % TILE_SIZE) * tile_cols(aj / TILE_SIZE) + aj % TILE_SIZE];
+}
+
+MoveResult TiledBoard::make_move(int i, int j) {
+	return reveal(window_top + i, window_left + j);
+}
+
+//Marks a mine as a known mine, without checking it like in the normal game
+void TiledBoard::mark_mine(int i, int j) {
+	long long ai = window_top + i;
+	long long aj = window_left + j;
+	Tile* t = get_tile(ai / TILE_SIZE, aj / TILE_SIZE);
+	t->states[(ai % TILE_SIZE) * tile_cols(aj / TILE_SIZE) + aj % TILE_SIZE] = KNOWN_MINE;
+	mines_marked++;
+	explored_top = min(explored_top, ai);
+	explored_bottom = max(explored_bottom, ai);
+	explored_left = min(explored_left, aj);
+	explored_right = max(explored_right, aj);
+}
+
+//Reveal a square, revealing all squares around it recursively if it has no adjacent mines
+//Returns result of the move
+MoveResult TiledBoard::reveal(long long i, long long j) {
+	move_count += 1;
+	State s = (State)get_tile(i / TILE_SIZE, j / TILE_SIZE)->states[(i % TILE_SIZE) * tile_cols(j / TILE_SIZE) + j % TILE_SIZE];
+	if (s == UNREVEALED_MINE || s == KNOWN_MINE) { //Making move on mine, game lost
+		active = false;
+		return LOSS;
+	}
+
+	stack<pair<long long, long long>> squares;
+	squares.push(make_pair(i, j));
+	while (!squares.empty()) { //Search recursively
+		pair<long long, long long> p = squares.top();
+		squares.pop();
+		Tile* t = get_tile(p.first / TILE_SIZE, p.second / TILE_SIZE);
+		int index = (p.first % TILE_SIZE) * tile_cols(p.second / TILE_SIZE) + p.second % TILE_SIZE;
+		if (t->states[index] == KNOWN_SAFE) continue;
+		t->states[index] = KNOWN_SAFE;
+		squares_revealed += 1;
+		explored_top = min(explored_top, p.first);
+		explored_bottom = max(explored_bottom, p.first);
+		explored_left = min(explored_left, p.second);
+		explored_right = max(explored_right, p.second);
+		if (t->counts[index] == 0) { //Append all adjacent squares to stack
+			for (int k = 0; k < 8; k++) {
+				long long ni = p.first + DIRECTIONS[k][0];
+				long long nj = p.second + DIRECTIONS[k][1];
+				if (ni >= 0 && ni < m_rows && nj >= 0 && nj < m_cols && get_state(ni, nj) != KNOWN_SAFE) {
+					squares.push(make_pair(ni, nj));
+				}
+			}
+		}
+	}
+
+	if (squares_revealed == m_rows * m_cols - m_mines) { //Game won if all safe squares revealed
+		active = false;
+		return WIN;
+	}
+	return CONTINUE;
+}
+
+//State of a square, unrevealed squares of tiles not generated yet are reported as unknown
+State TiledBoard::get_state(long long i, long long j) {
+	Tile* t = find_tile(i / TILE_SIZE, j / TILE_SIZE);
+	if (t == nullptr) {
+		return UNREVEALED_SAFE;
+	}
+	return (State)t->states[(i % TILE_SIZE) * tile_cols(j / TILE_SIZE) + j % TILE_SIZE];
+}
+
+//Get a tile if it has been generated, nullptr otherwise
+Tile* TiledBoard::find_tile(long long ti, long long tj) {
+	unordered_map<long long, Tile*>::iterator it = tiles.find(ti * tile_cols_count + tj);
+	if (it == tiles.end()) {
+		return nullptr;
+	}
+	return it->second;
+}
+
+//Get a tile, generating its mines and counts on first use
+//Counts of squares on the tile's border include mines of the neighbouring tiles, which are generated again but not stored
+Tile* TiledBoard::get_tile(long long ti, long long tj) {
+	Tile* t = find_tile(ti, tj);
+	if (t != nullptr) {
+		return t;
+	}
+
+	vector<char> halo[3][3]; //Mines of this tile and its neighbours
+	for (int di = -1; di <= 1; di++) {
+		for (int dj = -1; dj <= 1; dj++) {
+			if (ti + di >= 0 && ti + di < tile_rows_count && tj + dj >= 0 && tj + dj < tile_cols_count) {
+				generate_mines(ti + di, tj + dj, &halo[di + 1][dj + 1]);
+			}
+		}
+	}
+
+	t = new Tile;
+	long long rows = tile_rows(ti);
+	long long cols = tile_cols(tj);
+	t->states.resize(rows * cols);
+	t->counts.resize(rows * cols);
+	for (int r = 0; r < rows; r++) {
+		for (int c = 0; c < cols; c++) {
+			t->states[r * cols + c] = halo[1][1][r * cols + c] ? UNREVEALED_MINE : UNREVEALED_SAFE;
+			int count = 0;
+			for (int k = 0; k < 8; k++) {
+				long long ni = ti * TILE_SIZE + r + DIRECTIONS[k][0];
+				long long nj = tj * TILE_SIZE + c + DIRECTIONS[k][1];
+				if (ni < 0 || ni >= m_rows || nj < 0 || nj >= m_cols) continue;
+				long long nti = ni / TILE_SIZE;
+				long long ntj = nj / TILE_SIZE;
+				count += halo[nti - ti + 1][ntj - tj + 1][(ni % TILE_SIZE) * tile_cols(ntj) + nj % TILE_SIZE];
+			}
+			t->counts[r * cols + c] = count;
+		}
+	}
+	tiles[ti * tile_cols_count + tj] = t;
+	return t;
+}
+
+//Place the tile's share of mines uniformly within it, with a generator seeded by the board's seed and the tile
+//The first square of the board is kept free like a new terminal game
+void TiledBoard::generate_mines(long long ti, long long tj, vector<char>* mines) {
+	long long rows = tile_rows(ti);
+	long long cols = tile_cols(tj);
+	mines->assign(rows * cols, 0);
+	vector<int> candidates;
+	for (int p = (ti == 0 && tj == 0) ? 1 : 0; p < rows * cols; p++) {
+		candidates.push_back(p);
+	}
+	long long count = min(tile_mines(ti, tj), (long long)candidates.size());
+	mt19937_64 rng(mix_hash(m_seed ^ mix_hash(ti * tile_cols_count + tj)));
+	for (int k = 0; k < count; k++) { //Partial Fisher-Yates shuffle
+		uniform_int_distribution<int> dist(k, candidates.size() - 1);
+		swap(candidates[k], candidates[dist(rng)]);
+		(*mines)[candidates[k]] = 1;
+	}
+}
+
+//Share of the mines in a tile: the mines are spread over the squares in order of tiles (row-major),
+//with the count of each tile the difference of the rounded down shares of the squares up to and before it
+long long TiledBoard::tile_mines(long long ti, long long tj) {
+	long long total = m_rows * m_cols;
+	long long before = ti * TILE_SIZE * m_cols + tile_rows(ti) * tj * TILE_SIZE;
+	long long area = tile_rows(ti) * tile_cols(tj);
+	return m_mines * (before + area) / total - m_mines * before / total;
+}
+
+//Rows of the tiles in the given tile row (less for the last one)
+long long TiledBoard::tile_rows(long long ti) {
+	return min((long long)TILE_SIZE, m_rows - ti * TILE_SIZE);
+}
+
+//Columns of the tiles in the given tile column (less for the last one)
+long long TiledBoard::tile_cols(long long tj) {
+	return min((long long)TILE_SIZE, m_cols - tj * TILE_SIZE);
+}
+
+//Cover the explored tiles and a margin of tiles around them, so every revealed square has all of its neighbours in the window
+//The bot is reset whenever the window changes, as its state is kept in window coordinates
+void TiledBoard::update_window() {
+	long long top = max(0LL, explored_top / TILE_SIZE - TILE_MARGIN);
+	long long left = max(0LL, explored_left / TILE_SIZE - TILE_MARGIN);
+	long long bottom = min(tile_rows_count - 1, explored_bottom / TILE_SIZE + TILE_MARGIN);
+	long long right = min(tile_cols_count - 1, explored_right / TILE_SIZE + TILE_MARGIN);
+	int rows = (int)(min(m_rows, (bottom + 1) * TILE_SIZE) - top * TILE_SIZE);
+	int cols = (int)(min(m_cols, (right + 1) * TILE_SIZE) - left * TILE_SIZE);
+	if (top * TILE_SIZE == window_top && left * TILE_SIZE == window_left && rows == window_rows && cols == window_cols) {
+		return;
+	}
+
+	window_top = top * TILE_SIZE;
+	window_left = left * TILE_SIZE;
+	window_rows = rows;
+	window_cols = cols;
+	window_mines = 0;
+	for (long long ti = top; ti <= bottom; ti++) {
+		for (long long tj = left; tj <= right; tj++) {
+			window_mines += tile_mines(ti, tj);
+		}
+	}
+	m_bot.reset();
+	m_bot.set_board(this);
+}
@@ -0,0 +1,97 @@
+#ifndef TILED_BOARD_H
+#define TILED_BOARD_H
+
+#include <vector>
+#include <unordered_map>
+#include "util.h"
+#include "bot.h"
+#include "board_view.h"
+
+#define TILE_SIZE 64 //Rows and columns of each tile
+#define TILE_SQUARES (TILE_SIZE * TILE_SIZE)
+#define TILE_MARGIN 1 //Tiles of unexplored squares kept around the explored area in the bot's window
+
+struct Tile { //Squares of one tile, created the first time one of them is revealed or marked
+	std::vector<char> states; //State of each square in row-major order
+	std::vector<char> counts; //Number of adjacent mines of each square, including mines of the neighbouring tiles
+};
+
+//Board far too large to store, with mines generated one tile at a time the first time the tile is touched
+//The mines of each tile are placed by a random number generator seeded with a hash of the board's seed and the tile,
+//and each tile has a fixed share of the mines, so a tile never depends on which tiles were generated before it
+//The bot sees the board through a window covering the explored tiles and a margin around them, which grows as the game goes on
+class TiledBoard : public BoardView {
+public:
+	//Constructor and destructor
+	TiledBoard(long long rows, long long columns, long long num_mines, unsigned long long seed);
+	~TiledBoard();
+
+	//Key method: let the bot play its next move, growing its window first if needed
+	MoveResult next_move();
+	Bot* get_bot();
+
+	//Whole board accessor methods
+	long long get_total_rows();
+	long long get_total_cols();
+	long long get_total_mines();
+	long long get_total_revealed();
+	int get_tiles();
+	long long get_memory();
+	void print_stats();
+
+	//Window seen by the bot, in coordinates relative to its top left square
+	int get_rows();
+	int get_cols();
+	int get_mines();
+	int get_mines_marked();
+	int get_squares_revealed();
+	bool is_known(int i, int j);
+	bool is_safe(int i, int j);
+	bool is_marked_mine(int i, int j);
+	int get_count(int i, int j);
+	MoveResult make_move(int i, int j);
+	void mark_mine(int i, int j);
+
+private:
+	//Tile generation
+	Tile* get_tile(long long ti, long long tj);
+	Tile* find_tile(long long ti, long long tj);
+	void generate_mines(long long ti, long long tj, std::vector<char>* mines);
+	long long tile_mines(long long ti, long long tj);
+	long long tile_rows(long long ti);
+	long long tile_cols(long long tj);
+
+	//Moves in absolute coordinates
+	MoveResult reveal(long long i, long long j);
+	State get_state(long long i, long long j);
+	void update_window();
+
+	//Board setup values
+	long long m_rows;
+	long long m_cols;
+	long long m_mines;
+	long long tile_rows_count;
+	long long tile_cols_count;
+	unsigned long long m_seed;
+
+	//Board state
+	std::unordered_map<long long, Tile*> tiles;
+	long long squares_revealed;
+	long long mines_marked;
+	long long move_count;
+	bool active;
+
+	//Explored area (squares revealed or marked) and window in tiles
+	long long explored_top;
+	long long explored_bottom;
+	long long explored_left;
+	long long explored_right;
+	long long window_top;
+	long long window_left;
+	int window_rows;
+	int window_cols;
+	int window_mines;
+	Bot m_bot;
+};
+
+#endif //TILED_BOARD_H
@@ -0,0 +1,149 @@
+#include "bot.h"
+#include "board_view.h"
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace std;
+
+#define TEST_ROWS 16
+#define TEST_COLS 16
+#define TEST_MINES 40
+#define TEST_GAMES 200
+#define TEST_MOVE_LIMIT 1000
+#define TEST_TIME_BUDGET 0.05 //Milliseconds per move, short enough that edge searches run out of time and fall back to estimates
+#define TEST_EDGE_LIMIT 6 //Edge search limit without a time budget, low enough that sectioned search drops squares from edges
+
+//Board for the test, with the layout known so every mine the bot marks can be checked
+class TestBoard : public BoardView {
+public:
+	TestBoard(const vector<char>& layout) : mines(layout), states(layout.size(), UNREVEALED_SAFE), counts(layout.size(), 0) {
+		for (int i = 0; i < TEST_ROWS; i++) {
+			for (int j = 0; j < TEST_COLS; j++) {
+				for (int n : neighbours(i, j)) {
+					counts[i * TEST_COLS + j] += mines[n];
+				}
+			}
+		}
+	}
+
+	int get_rows() { return TEST_ROWS; }
+	int get_cols() { return TEST_COLS; }
+	int get_mines() { return TEST_MINES; }
+	int get_mines_marked() { return mines_marked; }
+	int get_squares_revealed() { return squares_revealed; }
+	bool is_known(int i, int j) { return states[i * TEST_COLS + j] != UNREVEALED_SAFE; }
+	bool is_safe(int i, int j) { return states[i * TEST_COLS + j] == KNOWN_SAFE; }
+	bool is_marked_mine(int i, int j) { return states[i * TEST_COLS + j] == KNOWN_MINE; }
+	int get_count(int i, int j) { return counts[i * TEST_COLS + j]; }
+
+	//Reveal a square, and the neighbours of revealed squares without adjacent mines
+	MoveResult make_move(int i, int j) {
+		if (mines[i * TEST_COLS + j]) {
+			return LOSS;
+		}
+		vector<int> stack{ i * TEST_COLS + j };
+		while (!stack.empty()) {
+			int p = stack.back();
+			stack.pop_back();
+			if (states[p] == KNOWN_SAFE) {
+				continue;
+			}
+			if (states[p] == KNOWN_MINE) { //A safe square marked as a mine is unmarked by the flood, but the bot was already wrong
+				mines_marked -= 1;
+			}
+			states[p] = KNOWN_SAFE;
+			squares_revealed += 1;
+			if (counts[p] == 0) {
+				for (int n : neighbours(p / TEST_COLS, p % TEST_COLS)) {
+					stack.push_back(n);
+				}
+			}
+		}
+		return squares_revealed == TEST_ROWS * TEST_COLS - TEST_MINES ? WIN : CONTINUE;
+	}
+
+	void mark_mine(int i, int j) {
+		int p = i * TEST_COLS + j;
+		if (!mines[p]) {
+			wrong_flags.push_back(make_pair(i, j));
+		}
+		states[p] = KNOWN_MINE;
+		mines_marked += 1;
+	}
+
+	vector<pair<int, int>> wrong_flags; //Safe squares the bot marked as mines
+
+private:
+	vector<int> neighbours(int i, int j) {
+		vector<int> result;
+		for (int di = -1; di <= 1; di++) {
+			for (int dj = -1; dj <= 1; dj++) {
+				int ni = i + di;
+				int nj = j + dj;
+				if ((di != 0 || dj != 0) && ni >= 0 && ni < TEST_ROWS && nj >= 0 && nj < TEST_COLS) {
+					result.push_back(ni * TEST_COLS + nj);
+				}
+			}
+		}
+		return result;
+	}
+
+	vector<char> mines;
+	vector<State> states;
+	vector<int> counts;
+	int mines_marked = 0;
+	int squares_revealed = 0;
+};
+
+//Play games checking that the bot never marks a safe square as a mine and that every game ends
+//Returns false on the first wrong mine or unfinished game
+static bool play_games(unsigned seed, double time_budget, int edge_limit) {
+	mt19937 rng(seed);
+	int wins = 0;
+	for (int game = 0; game < TEST_GAMES; game++) {
+		vector<char> layout(TEST_ROWS * TEST_COLS, 0);
+		vector<int> candidates;
+		for (int p = 1; p < TEST_ROWS * TEST_COLS; p++) { //Opening square is never a mine
+			candidates.push_back(p);
+		}
+		for (int k = 0; k < TEST_MINES; k++) { //Partial Fisher-Yates shuffle
+			uniform_int_distribution<int> dist(k, candidates.size() - 1);
+			swap(candidates[k], candidates[dist(rng)]);
+			layout[candidates[k]] = 1;
+		}
+
+		TestBoard board(layout);
+		Bot bot;
+		bot.set_verbose(false);
+		bot.set_move_time_budget(time_budget);
+		bot.set_edge_search_limit(edge_limit);
+		bot.set_random_seed(seed + game);
+		bot.set_board(&board);
+		MoveResult res = CONTINUE;
+		int moves = 0;
+		while (res == CONTINUE && moves < TEST_MOVE_LIMIT && board.wrong_flags.empty()) {
+			res = bot.select_next_move();
+			moves += 1;
+		}
+		if (!board.wrong_flags.empty()) {
+			cout << "Game " << game << " (" << time_budget << " ms budget, edge limit " << edge_limit << "): safe square " << board.wrong_flags[0].first << "," << board.wrong_flags[0].second << " marked as a mine on move " << moves << endl;
+			return false;
+		}
+		if (res == CONTINUE) {
+			cout << "Game " << game << " (" << time_budget << " ms budget, edge limit " << edge_limit << "): not finished after " << TEST_MOVE_LIMIT << " moves" << endl;
+			return false;
+		}
+		wins += res == WIN;
+	}
+	cout << "No safe square marked as a mine in " << TEST_GAMES << " games with a " << time_budget << " ms budget and an edge limit of " << edge_limit << " (" << wins << " won)" << endl;
+	return true;
+}
+
+//Plays games with a short time budget per move, then with a low edge search limit and no time budget
+int main(int argc, char* argv[]) {
+	unsigned seed = argc > 1 ? (unsigned)atoi(argv[1]) : 1;
+	bool ok = play_games(seed, TEST_TIME_BUDGET, 10);
+	ok = play_games(seed, 0, TEST_EDGE_LIMIT) && ok;
+	return ok ? 0 : 1;
+}
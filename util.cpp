@@ -1,134 +1,192 @@
-#include <iostream>
-#include <stack>
-#include <unordered_set>
-#include <unordered_map>
-#include "board.h"
-#include "util.h"
-
-//Hashes pair of integers
-int hash_pair(unordered_set<pair<int, int>, PairHashStruct>::iterator p) {
-	return ((p->first + p->second) * (p->first + p->second + 1) / 2) + p->second;
-}
-
-//Hashes set of pair of integers (linear time with length of set)
-int hash_set(unordered_set<pair<int, int>, PairHashStruct> set)
-{
-	int tot = 0;
-	for (unordered_set<pair<int, int>, PairHashStruct>::iterator p = set.begin(); p != set.end(); p++) {
-		tot ^= hash_pair(p);
-	}
-	return tot;
-}
-
-//Calculates if a set is a subset of another (linear time)
-bool is_subset(const unordered_set<pair<int, int>, PairHashStruct> set, const unordered_set<pair<int, int>, PairHashStruct> sub) {
-	if (set.size() < sub.size()) {
-		return false;
-	}
-	for (pair<int, int> p : sub) {
-		if (set.find(p) == set.end()) {
-			return false;
-		}
-	}
-	return true;
-}
-
-//Executes a function on each square adjacent to a specific square
-//Provides void* arg as an arbitrary pointer to be used by the callback as necessary
-void execute_callback(Board* b, int i, int j, void (*callback)(int i, int j, Board*, void* arg), void* arg) {
-	for (int k = 0; k < 8; k++) {
-		if (i + DIRECTIONS[k][0] >= 0 && i + DIRECTIONS[k][0] < b->get_rows() && j + DIRECTIONS[k][1] >= 0 && j + DIRECTIONS[k][1] < b->get_cols()) {
-			callback(i + DIRECTIONS[k][0], j + DIRECTIONS[k][1], b, arg);
-		}
-	}
-}
-
-//Marks all squares adjacent to a specific square as a known mine
-void mark_as_known_mine(int i, int j, Board* board, void* p) {
-	if (!board->is_known(i, j)) {
-		board->mark_mine(i, j);
-	}
-}
-
-//Counts all adjacent squares with unknown state
-void count_unknown_spaces(int i, int j, Board* board, void* count) {
-	int* c = (int*)count;
-	if (!board->is_known(i, j)) {
-		*c += 1;
-	}
-}
-
-//Counts all adjacent squares known to be mines
-void count_known_mines(int i, int j, Board* board, void* count) {
-	int* c = (int*)count;
-	if (board->is_marked_mine(i, j)) {
-		*c += 1;
-	}
-}
-
-//Counts total number of adjacent mines (revealed and unrevealed) adjacent to a square
-//Not used by bot
-void count_mines(int i, int j, Board* board, void* count) {
-	int* c = (int*)count;
-	State mines[2]{ UNREVEALED_MINE, KNOWN_MINE };
-	if (board->square_has_state(i, j, mines, 2)) {
-		*c += 1;
-	}
-}
-
-//Decrements count for each adjacent safe square
-void decrement_count(int i, int j, Board* board, void* map) {
-	unordered_map<pair<int, int>, int, PairHashStruct>* m = (unordered_map<pair<int, int>, int, PairHashStruct>*) map;
-	if (board->is_safe(i, j)) {
-		(*m)[make_pair(i, j)] -= 1;
-	}
-}
-
-//Pushes all adjacent safe squares to stack
-void append_to_stack(int i, int j, Board* board, void* st) {
-	if (!board->is_safe(i, j)) {
-		stack<pair<int, int>>* s = (stack<pair<int, int>>*)st;
-		s->push(make_pair(i, j));
-	}
-}
-
-//Appends all adjacent unknown squares to vector
-void append_to_vector(int i, int j, Board* board, void* vt) {
-	vector<pair<int, int>>* v = (vector<pair<int, int>>*) vt;
-	if (!board->is_known(i, j)) {
-		v->push_back(make_pair(i, j));
-	}
-}
-
-//Appends all adjacent known squares to vector
-void append_known_to_vector(int i, int j, Board* board, void* vt) {
-	vector<pair<int, int>>* v = (vector<pair<int, int>>*) vt;
-	if (board->is_known(i, j)) {
-		v->push_back(make_pair(i, j));
-	}
-}
-
-//Inserts all adjacent squares into map as key value pair of pair to number of adjacent mines
-void insert_into_map(int i, int j, Board* board, void* map) {
-	unordered_map<pair<int, int>, int, PairHashStruct>* m = (unordered_map<pair<int, int>, int, PairHashStruct>*) map;
-	if (board->is_safe(i, j)) {
-		(*m)[make_pair(i, j)] = board->get_count(i, j);
-	}
-}
-
-//Inserts all adjacent unknown squares to set
-void build_adjacency_set(int i, int j, Board* board, void* map) {
-	unordered_set<pair<int, int>, PairHashStruct>* m = (unordered_set<pair<int, int>, PairHashStruct>*) map;
-	if (!board->is_known(i, j)) {
-		(*m).insert(make_pair(i, j));
-	}
-}
-
-//Inserts all adjacent known squares to set if they are not in the map keyset
-void build_interior_interior_set(int i, int j, Board* board, void* maps) {
-	MapStruct* m = (MapStruct*)maps;
-	if (board->is_known(i, j) && m->map->find(make_pair(i, j)) != m->map->end()) {
-		m->set->insert(make_pair(i, j));
-	}
-
+#include <iostream>
+#include <stack>
+#include <unordered_set>
+#include <unordered_map>
+#include <algorithm>
+#include "board_view.h"
+#include "util.h"
+
+//Hashes pair of integers
+int hash_pair(unordered_set<pair<int, int>, PairHashStruct>::iterator p) {
+	return ((p->first + p->second) * (p->first + p->second + 1) / 2) + p->second;
+}
+
+//Hashes set of pair of integers (linear time with length of set)
+int hash_set(unordered_set<pair<int, int>, PairHashStruct> set)
+{
+	int tot = 0;
+	for (unordered_set<pair<int, int>, PairHashStruct>::iterator p = set.begin(); p != set.end(); p++) {
+		tot ^= hash_pair(p);
+	}
+	return tot;
+}
+
+//Mixes bits of a 64 bit integer (splitmix64 finalizer)
+unsigned long long mix_hash(unsigned long long x) {
+	x += 0x9e3779b97f4a7c15ULL;
+	x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+	return x ^ (x >> 31);
+}
+
+//Hashes an edge by its squares and its constraints with their remaining mine counts (independent of order)
+//Any reveal or flag touching the edge changes the hash
+unsigned long long hash_edge(BoardView* b, vector<pair<int, int>>* edge) {
+	unordered_map<pair<int, int>, int, PairHashStruct> constraints;
+	unsigned long long tot = 0;
+	for (pair<int, int> p : *edge) {
+		execute_callback(b, p.first, p.second, &insert_into_map, &constraints);
+		tot += mix_hash(((unsigned long long)p.first << 32) | (unsigned int)p.second);
+	}
+	for (pair<pair<int, int>, int> c : constraints) {
+		int flag_count = 0;
+		execute_callback(b, c.first.first, c.first.second, &count_known_mines, &flag_count);
+		tot += mix_hash((1ULL << 63) | ((unsigned long long)c.first.first << 36) | ((unsigned long long)c.first.second << 8) | (c.second - flag_count));
+	}
+	return tot;
+}
+
+//Calculates if a set is a subset of another (linear time)
+bool is_subset(const unordered_set<pair<int, int>, PairHashStruct>& set, const unordered_set<pair<int, int>, PairHashStruct>& sub) {
+	if (set.size() < sub.size()) {
+		return false;
+	}
+	for (pair<int, int> p : sub) {
+		if (set.find(p) == set.end()) {
+			return false;
+		}
+	}
+	return true;
+}
+
+//Executes a function on each square adjacent to a specific square
+//Provides void* arg as an arbitrary pointer to be used by the callback as necessary
+void execute_callback(BoardView* b, int i, int j, void (*callback)(int i, int j, BoardView*, void* arg), void* arg) {
+	for (int k = 0; k < 8; k++) {
+		if (i + DIRECTIONS[k][0] >= 0 && i + DIRECTIONS[k][0] < b->get_rows() && j + DIRECTIONS[k][1] >= 0 && j + DIRECTIONS[k][1] < b->get_cols()) {
+			callback(i + DIRECTIONS[k][0], j + DIRECTIONS[k][1], b, arg);
+		}
+	}
+}
+
+//Approximate bytes held by a node of an edge subset tree, including its sets and list of children
+long long adjacency_node_bytes(AdjacencyOrderingNode* node) {
+	long long set_node = sizeof(void*) + sizeof(pair<int, int>);
+	long long buckets = node->visited.bucket_count() + node->current_squares.bucket_count();
+	return sizeof(AdjacencyOrderingNode) + (node->visited.size() + node->current_squares.size()) * set_node + buckets * sizeof(void*) + node->children.capacity() * sizeof(AdjacencyOrderingNode*);
+}
+
+//Frees every node of an edge subset tree, deleting leaves first
+void free_adjacency_tree(vector<AdjacencyOrderingNode*>* roots) {
+	vector<AdjacencyOrderingNode*> queue;
+	for (AdjacencyOrderingNode* root : *roots) {
+		queue.push_back(root);
+	}
+
+	while (!queue.empty()) {
+		AdjacencyOrderingNode* node = queue.back();
+		queue.pop_back();
+		if (node->children.size() == 0) { //Delete leaf node
+			if (node->parent != nullptr) {
+				node->parent->children.erase(find(node->parent->children.begin(), node->parent->children.end(), node));
+				if (node->parent->children.size() == 0) {
+					queue.push_back(node->parent); //Check parent of leaf node also
+				}
+			}
+			delete node;
+		}
+		else {
+			for (AdjacencyOrderingNode* n : node->children) {
+				queue.push_back(n); //Check children if not leaf node
+			}
+		}
+	}
+}
+
+//Marks all squares adjacent to a specific square as a known mine
+void mark_as_known_mine(int i, int j, BoardView* board, void* p) {
+	if (!board->is_known(i, j)) {
+		board->mark_mine(i, j);
+	}
+}
+
+//Counts all adjacent squares with unknown state
+void count_unknown_spaces(int i, int j, BoardView* board, void* count) {
+	int* c = (int*)count;
+	if (!board->is_known(i, j)) {
+		*c += 1;
+	}
+}
+
+//Counts all adjacent squares known to be mines
+void count_known_mines(int i, int j, BoardView* board, void* count) {
+	int* c = (int*)count;
+	if (board->is_marked_mine(i, j)) {
+		*c += 1;
+	}
+}
+
+//Counts all adjacent squares known to be safe
+void count_safe_spaces(int i, int j, BoardView* board, void* count) {
+	int* c = (int*)count;
+	if (board->is_safe(i, j)) {
+		*c += 1;
+	}
+}
+
+//Decrements count for each adjacent safe square
+void decrement_count(int i, int j, BoardView* board, void* map) {
+	unordered_map<pair<int, int>, int, PairHashStruct>* m = (unordered_map<pair<int, int>, int, PairHashStruct>*) map;
+	if (board->is_safe(i, j)) {
+		(*m)[make_pair(i, j)] -= 1;
+	}
+}
+
+//Pushes all adjacent safe squares to stack
+void append_to_stack(int i, int j, BoardView* board, void* st) {
+	if (!board->is_safe(i, j)) {
+		stack<pair<int, int>>* s = (stack<pair<int, int>>*)st;
+		s->push(make_pair(i, j));
+	}
+}
+
+//Appends all adjacent unknown squares to vector
+void append_to_vector(int i, int j, BoardView* board, void* vt) {
+	vector<pair<int, int>>* v = (vector<pair<int, int>>*) vt;
+	if (!board->is_known(i, j)) {
+		v->push_back(make_pair(i, j));
+	}
+}
+
+//Appends all adjacent known squares to vector
+void append_known_to_vector(int i, int j, BoardView* board, void* vt) {
+	vector<pair<int, int>>* v = (vector<pair<int, int>>*) vt;
+	if (board->is_known(i, j)) {
+		v->push_back(make_pair(i, j));
+	}
+}
+
+//Inserts all adjacent squares into map as key value pair of pair to number of adjacent mines
+void insert_into_map(int i, int j, BoardView* board, void* map) {
+	unordered_map<pair<int, int>, int, PairHashStruct>* m = (unordered_map<pair<int, int>, int, PairHashStruct>*) map;
+	if (board->is_safe(i, j)) {
+		(*m)[make_pair(i, j)] = board->get_count(i, j);
+	}
+}
+
+//Inserts all adjacent unknown squares to set
+void build_adjacency_set(int i, int j, BoardView* board, void* map) {
+	unordered_set<pair<int, int>, PairHashStruct>* m = (unordered_set<pair<int, int>, PairHashStruct>*) map;
+	if (!board->is_known(i, j)) {
+		(*m).insert(make_pair(i, j));
+	}
+}
+
+//Inserts all adjacent known squares to set if they are not in the map keyset
+void build_interior_interior_set(int i, int j, BoardView* board, void* maps) {
+	MapStruct* m = (MapStruct*)maps;
+	if (board->is_known(i, j) && m->map->find(make_pair(i, j)) != m->map->end()) {
+		m->set->insert(make_pair(i, j));
+	}
+
 }
\ No newline at end of file
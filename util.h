@@ -1,98 +1,162 @@
-#ifndef UTIL_H
-#define UTIL_H
-
-#include <unordered_set>
-#include <unordered_map>
-
-#define NUM_THREADS 4
-
-using namespace std;
-class Board;
-
-enum State { //Potential states for each square
-	UNREVEALED_MINE,
-	KNOWN_MINE,
-	UNREVEALED_SAFE,
-	KNOWN_SAFE
-};
-
-enum ActionType { //Potential actions to be handled by board
-	USER_DEFINED_MOVE,
-	NEXT_MOVE,
-	RESET,
-	PRINT_COUNTS,
-	SIMULATE,
-};
-enum MoveResult { //Results of each move
-	WIN,
-	CONTINUE,
-	LOSS,
-};
-
-enum Option { //User-defined options
-	ROWS,
-	COLUMNS,
-	MINES,
-	MAX_EDGE_SIZE,
-	NO_OPT,
-};
-
-struct Action { //Package action with type and flexible instruction pointer
-	ActionType type;
-	void* info;
-};
-
-struct PairHashStruct { //Hash function for pair of integers
-	inline size_t operator()(const pair<int, int>& p) const
-	{
-		return ((p.first + p.second) * (p.first + p.second + 1) / 2) + p.second;
-	}
-};
-
-struct AdjacencyOrderingNode { //Node for edge subset tree
-	pair<int, int> coord;
-	unordered_set<pair<int, int>, PairHashStruct> current_squares;
-	unordered_set<pair<int, int>, PairHashStruct> visited;
-	vector<AdjacencyOrderingNode*> children;
-	AdjacencyOrderingNode* parent;
-};
-struct MapStruct { //Package two maps for use with callback format
-	unordered_set<pair<int, int>, PairHashStruct>* set;
-	unordered_map<pair<int, int>, int, PairHashStruct>* map;
-};
-
-const static int DIRECTIONS[8][2]{ //Helper array for callbacks
-	{0,1},
-	{0,-1},
-	{1,0},
-	{-1,0},
-	{1,1},
-	{-1,1},
-	{1,-1},
-	{-1,-1}
-};
-
-//Hash functions
-int hash_pair(unordered_set<pair<int, int>, PairHashStruct>::iterator p);
-int hash_set(unordered_set<pair<int, int>, PairHashStruct> set);
-
-//General utility functions
-void execute_callback(Board* b, int i, int j, void (*callback)(int i, int j, Board*, void* arg), void* arg);
-bool is_subset(const unordered_set<pair<int, int>, PairHashStruct> set, const unordered_set<pair<int, int>, PairHashStruct> sub);
-void mark_as_known_mine(int i, int j, Board* board, void* p);
-
-//Counting functions
-void count_unknown_spaces(int i, int j, Board* board, void* count);
-void count_known_mines(int i, int j, Board* board, void* count);
-void count_mines(int i, int j, Board* board, void* count);
-void decrement_count(int i, int j, Board* board, void* map);
-
-//Appending functions
-void append_to_stack(int i, int j, Board* board, void* st);
-void append_to_vector(int i, int j, Board* board, void* vt);
-void append_known_to_vector(int i, int j, Board* board, void* vt);
-void insert_into_map(int i, int j, Board* board, void* map);
-void build_adjacency_set(int i, int j, Board* board, void* map);
-void build_interior_interior_set(int i, int j, Board* board, void* maps);
-
+#ifndef UTIL_H
+#define UTIL_H
+
+#include <unordered_set>
+#include <unordered_map>
+#include <vector>
+
+#define NUM_THREADS 4
+
+using namespace std;
+class BoardView;
+
+enum State { //Potential states for each square
+	UNREVEALED_MINE,
+	KNOWN_MINE,
+	UNREVEALED_SAFE,
+	KNOWN_SAFE
+};
+
+enum ActionType { //Potential actions to be handled by board
+	USER_DEFINED_MOVE,
+	NEXT_MOVE,
+	RESET,
+	PRINT_COUNTS,
+	SIMULATE,
+	GENERATE,
+	LOCKSTEP_SIMULATE,
+	AUTOTUNE,
+};
+enum MoveResult { //Results of each move
+	WIN,
+	CONTINUE,
+	LOSS,
+	GUESS_REQUIRED,
+};
+
+enum SolverTier { //Search producing the last move, ordered from most to least precise
+	SINGLE_SQUARE,
+	PAIRWISE,
+	PRECISE,
+	SAMPLED,
+	SECTIONED,
+	ESTIMATE,
+};
+
+enum Option { //User-defined options
+	ROWS,
+	COLUMNS,
+	MINES,
+	MAX_EDGE_SIZE,
+	TIME_BUDGET,
+	SAMPLE_BUDGET,
+	PATTERN_CACHE,
+	ENDGAME_SQUARES,
+	ENDGAME_MINES,
+	LOOKAHEAD,
+	LOOKAHEAD_TIME,
+	TILED_MOVES,
+	SEARCH_THREADS,
+	NODE_BUDGET,
+	MEMORY_BUDGET,
+	COST_MODEL,
+	MOVE_TARGET,
+	SEED,
+	SEED_FILE,
+	RECORDS,
+	SHARDS,
+	GAMES,
+	RUN_SEED,
+	SHARD_STATS,
+	NO_OPT,
+};
+
+struct Action { //Package action with type and flexible instruction pointer
+	ActionType type;
+	void* info;
+};
+
+struct PairHashStruct { //Hash function for pair of integers
+	inline size_t operator()(const pair<int, int>& p) const
+	{
+		return ((p.first + p.second) * (p.first + p.second + 1) / 2) + p.second;
+	}
+};
+
+struct AdjacencyOrderingNode { //Node for edge subset tree
+	pair<int, int> coord;
+	unordered_set<pair<int, int>, PairHashStruct> current_squares;
+	unordered_set<pair<int, int>, PairHashStruct> visited;
+	vector<AdjacencyOrderingNode*> children;
+	AdjacencyOrderingNode* parent;
+	bool duplicate; //Same constraints and last constraint as a node already expanded, so left without children
+};
+struct EdgeSolution { //Cached result of searching one edge
+	std::vector<std::pair<int, int>> squares; //Their probabilities are left in the bot's probability array until the edge changes
+	std::vector<double> confidence;
+	std::vector<double> histogram; //Number of possibilities with each number of mines (precise search only)
+	double mine_count;
+	SolverTier tier;
+};
+
+struct EdgeLayout { //Compact form of an edge for the solvers, with squares as flat ids (row * columns + column)
+	std::vector<int> squares;
+	std::vector<int> constraint_start; //Offset of each constraint's squares in constraint_squares, followed by the total
+	std::vector<int> constraint_squares; //Index in squares of each unknown square of each constraint
+	std::vector<int> remaining; //Mines still to place among each constraint's squares
+};
+
+struct GameStats { //Moves and search work of the bot over one game
+	int moves;
+	int guesses;
+	int largest_edge; //Squares of the largest edge searched
+	double single_square_time; //Time of each search in microseconds
+	double pairwise_time;
+	double edge_time;
+	double guess_time;
+};
+
+struct MapStruct { //Package two maps for use with callback format
+	unordered_set<pair<int, int>, PairHashStruct>* set;
+	unordered_map<pair<int, int>, int, PairHashStruct>* map;
+};
+
+constexpr static int DIRECTIONS[8][2]{ //Helper array for callbacks
+	{0,1},
+	{0,-1},
+	{1,0},
+	{-1,0},
+	{1,1},
+	{-1,1},
+	{1,-1},
+	{-1,-1}
+};
+
+//Hash functions
+int hash_pair(unordered_set<pair<int, int>, PairHashStruct>::iterator p);
+int hash_set(unordered_set<pair<int, int>, PairHashStruct> set);
+unsigned long long mix_hash(unsigned long long x);
+unsigned long long hash_edge(BoardView* b, std::vector<std::pair<int, int>>* edge);
+
+//General utility functions
+void execute_callback(BoardView* b, int i, int j, void (*callback)(int i, int j, BoardView*, void* arg), void* arg);
+bool is_subset(const unordered_set<pair<int, int>, PairHashStruct>& set, const unordered_set<pair<int, int>, PairHashStruct>& sub);
+void mark_as_known_mine(int i, int j, BoardView* board, void* p);
+void free_adjacency_tree(std::vector<AdjacencyOrderingNode*>* roots);
+long long adjacency_node_bytes(AdjacencyOrderingNode* node);
+
+//Counting functions
+void count_unknown_spaces(int i, int j, BoardView* board, void* count);
+void count_known_mines(int i, int j, BoardView* board, void* count);
+void count_safe_spaces(int i, int j, BoardView* board, void* count);
+void decrement_count(int i, int j, BoardView* board, void* map);
+
+//Appending functions
+void append_to_stack(int i, int j, BoardView* board, void* st);
+void append_to_vector(int i, int j, BoardView* board, void* vt);
+void append_known_to_vector(int i, int j, BoardView* board, void* vt);
+void insert_into_map(int i, int j, BoardView* board, void* map);
+void build_adjacency_set(int i, int j, BoardView* board, void* map);
+void build_interior_interior_set(int i, int j, BoardView* board, void* maps);
+
 #endif
\ No newline at end of file